@@ -0,0 +1,31 @@
+#include "AllocationCount.h"
+#include <stdlib.h>
+#include <new>
+
+// Every operator new counts itself.  The replacements live in their own translation unit,
+// so no caller can inline them and pair them up against the library's built-in versions
+// (g++ warns -Wmismatched-new-delete when it can see both).
+// Replacing them means replacing the whole set: plain, array, nothrow, and the sized deletes
+// (C++14 and up call those), which all go to malloc/free.  The aligned ones (C++17) are left to
+// the library, which pairs its own aligned new and delete.
+atomic<long long> numAllocations( 0 ) ;
+
+void* operator new( size_t size, const nothrow_t& ) noexcept
+{
+  numAllocations.fetch_add( 1, memory_order_relaxed ) ;
+  return malloc( size ? size : 1 ) ;
+}
+void* operator new( size_t size )
+{
+  void* p = operator new( size, nothrow ) ;
+  if( !p )  throw bad_alloc() ;
+  return p ;
+}
+void* operator new[]( size_t size ) { return operator new( size ) ; }
+void* operator new[]( size_t size, const nothrow_t& ) noexcept { return operator new( size, nothrow ) ; }
+void operator delete( void* p ) noexcept { free( p ) ; }
+void operator delete[]( void* p ) noexcept { free( p ) ; }
+void operator delete( void* p, const nothrow_t& ) noexcept { free( p ) ; }
+void operator delete[]( void* p, const nothrow_t& ) noexcept { free( p ) ; }
+void operator delete( void* p, size_t ) noexcept { free( p ) ; }
+void operator delete[]( void* p, size_t ) noexcept { free( p ) ; }
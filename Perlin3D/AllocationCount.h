@@ -0,0 +1,11 @@
+#ifndef ALLOCATIONCOUNT_H
+#define ALLOCATIONCOUNT_H
+
+#include <atomic>
+using namespace std ;
+
+// How many times operator new has been called (see AllocationCount.cpp),
+// so -bench can show how many allocations a regen makes.
+extern atomic<long long> numAllocations ;
+
+#endif
@@ -0,0 +1,427 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include "Mesh.h"
+#include <queue>
+
+// A quadric error metric (Garland & Heckbert): the sum of squared distances
+// from a point to a set of planes, kept as the 10 unique entries of the symmetric 4x4
+//   [ A  b ]
+//   [ b' c ]
+// so that error(p) = p'Ap + 2b.p + c.  Doubles, because the entries get summed a lot.
+struct Quadric
+{
+  double a00, a01, a02, a11, a12, a22 ; // A
+  double b0, b1, b2 ;                   // b
+  double c ;
+
+  Quadric() : a00(0),a01(0),a02(0),a11(0),a12(0),a22(0), b0(0),b1(0),b2(0), c(0)
+  {
+  }
+
+  // the plane through p with unit normal n
+  Quadric( const Vector3f& n, const Vector3f& p )
+  {
+    double d = -n.dot( p ) ;
+    a00 = n.x*n.x ;  a01 = n.x*n.y ;  a02 = n.x*n.z ;
+    a11 = n.y*n.y ;  a12 = n.y*n.z ;  a22 = n.z*n.z ;
+    b0 = n.x*d ;  b1 = n.y*d ;  b2 = n.z*d ;
+    c = d*d ;
+  }
+
+  Quadric& operator+=( const Quadric& o )
+  {
+    a00 += o.a00 ;  a01 += o.a01 ;  a02 += o.a02 ;
+    a11 += o.a11 ;  a12 += o.a12 ;  a22 += o.a22 ;
+    b0 += o.b0 ;  b1 += o.b1 ;  b2 += o.b2 ;
+    c += o.c ;
+    return *this ;
+  }
+
+  Quadric operator+( const Quadric& o ) const
+  {
+    Quadric q = *this ;
+    return q += o ;
+  }
+
+  double error( const Vector3f& p ) const
+  {
+    double x = p.x, y = p.y, z = p.z ;
+    return x*( a00*x + 2*( a01*y + a02*z + b0 ) ) +
+           y*( a11*y + 2*( a12*z + b1 ) ) +
+           z*( a22*z + 2*b2 ) + c ;
+  }
+
+  // The point with the least error (solves Ap = -b).
+  // false if A is (nearly) singular, ie the planes don't pin a point down.
+  bool minimizer( Vector3f& p ) const
+  {
+    // cofactors of the symmetric A
+    double c00 = a11*a22 - a12*a12, c01 = a02*a12 - a01*a22, c02 = a01*a12 - a02*a11 ;
+    double det = a00*c00 + a01*c01 + a02*c02 ;
+    double scale = a00 + a11 + a22 ;
+    if( fabs( det ) < 1e-6*scale*scale*scale )  return false ;
+    double c11 = a00*a22 - a02*a02, c12 = a01*a02 - a00*a12, c22 = a00*a11 - a01*a01 ;
+    p.x = (float)( -( c00*b0 + c01*b1 + c02*b2 ) / det ) ;
+    p.y = (float)( -( c01*b0 + c11*b1 + c12*b2 ) / det ) ;
+    p.z = (float)( -( c02*b0 + c12*b1 + c22*b2 ) / det ) ;
+    return true ;
+  }
+} ;
+
+// Simplifies an indexed Mesh by edge collapses, cheapest (by quadric error) first,
+// until it gets down to a triangle budget or the next collapse would cost too much.
+//
+// The periodic walls stay seamless: vertices on a wall (vertexWallHits, from gatherEdgeData)
+// are locked.  A collapse may pull an interior vertex onto a wall vertex, but never moves or
+// removes a wall vertex, and edges between 2 wall vertices never collapse, so both sides
+// of every seam keep exactly the vertices and edges they had.
+struct Decimator
+{
+  Mesh* mesh ;
+  VoxelGrid* voxelGrid ;
+
+  vector<Quadric> quadrics ;      // per vertex: the planes of its original triangles (and boundary edges)
+
+  // The triangles around each vertex (may include dead ones): mesh's VertexTriangles, copied,
+  // where a vertex's list is its own row, then the rows of the verts that merged into it
+  // (nextRow), each only used up to rowLen.  A collapse links from's rows onto to's,
+  // then packs to's live triangles to the front, so nothing is ever allocated per vertex.
+  VertexTriangles vertTris ;
+  vector<int> rowLen, nextRow ;
+  vector<char> triDead, vertDead, locked ;
+  vector<int> version ;           // bumped whenever a vertex moves, so stale collapses can be spotted
+  vector<int> mark ;              // scratch per vertex, for the link test
+  int markStamp ;
+  int liveTris ;
+
+  struct Collapse
+  {
+    float cost ;
+    int from, to ;               // from merges into to
+    int fromVersion, toVersion ;
+    Vector3f target ;            // where to ends up
+    // priority_queue pops the largest, so the cheapest has to compare largest
+    bool operator<( const Collapse& o ) const { return cost > o.cost ; }
+  } ;
+  priority_queue<Collapse> heap ;
+
+  Decimator( Mesh* iMesh, VoxelGrid* iVoxelGrid ) : mesh( iMesh ), voxelGrid( iVoxelGrid ), markStamp( 0 ), liveTris( 0 )
+  {
+  }
+
+  inline int* tri( int t ) { return &mesh->indices[3*t] ; }
+
+  // for( int t : trisOf( v ) ): the triangles in v's chain of rows
+  struct TriChain
+  {
+    const Decimator* d ;
+    int v ;
+
+    struct iterator
+    {
+      const Decimator* d ;
+      int row, k ;
+      // past the end of a row, on to the next one with something in it
+      void settle() {
+        while( row != -1 && k == d->rowLen[row] )
+          row = d->nextRow[row], k = 0 ;
+      }
+      int operator*() const { return d->vertTris.tris[ d->vertTris.start[row] + k ] ; }
+      iterator& operator++() { k++ ; settle() ; return *this ; }
+      bool operator!=( const iterator& o ) const { return row != o.row || k != o.k ; }
+    } ;
+    iterator begin() const { iterator it = { d, v, 0 } ; it.settle() ; return it ; }
+    iterator end() const { iterator it = { d, -1, 0 } ; return it ; }
+  } ;
+
+  TriChain trisOf( int v ) const
+  {
+    TriChain chain = { this, v } ;
+    return chain ;
+  }
+
+  // the normal a vertex gets when a vertex with normal n2 merges into it (normal n1)
+  static Vector3f mergedNormal( const Vector3f& n1, const Vector3f& n2 )
+  {
+    return ( n1 + n2 ).normalize() ;
+  }
+
+  // where the best collapse of edge (u,v) goes, and what it costs.  false if it can't collapse.
+  bool planCollapse( int u, int v, Collapse& col ) const
+  {
+    if( locked[u] && locked[v] )  return false ;
+    if( locked[u] )  swap( u, v ) ; // only ever merge into the locked one
+    const Vector3f& pu = mesh->verts[u].pos ;
+    const Vector3f& pv = mesh->verts[v].pos ;
+    Quadric q = quadrics[u] + quadrics[v] ;
+
+    col.from = u, col.to = v ;
+    if( locked[v] )
+      col.target = pv ;
+    else if( !q.minimizer( col.target ) )
+    {
+      // flat or straight: the best of the ends and the middle
+      Vector3f mid = ( pu + pv ) / 2 ;
+      col.target = pv ;
+      if( q.error( pu ) < q.error( col.target ) )  col.target = pu ;
+      if( q.error( mid ) < q.error( col.target ) )  col.target = mid ;
+    }
+    col.cost = (float)max( 0.0, q.error( col.target ) ) ;
+    col.fromVersion = version[u], col.toVersion = version[v] ;
+    return true ;
+  }
+
+  void pushEdge( int u, int v )
+  {
+    Collapse col ;
+    if( planCollapse( u, v, col ) )
+      heap.push( col ) ;
+  }
+
+  // Would collapsing from into to (at target) keep the mesh manifold and unflipped?
+  bool canCollapse( const Collapse& col )
+  {
+    int from = col.from, to = col.to ;
+
+    // link condition: from and to may only share the neighbours across their shared triangles
+    markStamp++ ;
+    for( int t : trisOf( to ) )
+    {
+      if( triDead[t] )  skip ;
+      for( int c = 0 ; c < 3 ; c++ )
+        mark[ tri(t)[c] ] = markStamp ;
+    }
+    int sharedTris = 0, sharedVerts = 0 ;
+    for( int t : trisOf( from ) )
+    {
+      if( triDead[t] )  skip ;
+      int* ixs = tri(t) ;
+      if( ixs[0] == to || ixs[1] == to || ixs[2] == to )
+        sharedTris++ ;
+      for( int c = 0 ; c < 3 ; c++ )
+        if( ixs[c] != from && ixs[c] != to && mark[ ixs[c] ] == markStamp )
+        {
+          sharedVerts++ ;
+          mark[ ixs[c] ] = markStamp - 1 ; // count each once
+        }
+    }
+    if( sharedTris == 0 || sharedVerts != sharedTris )  return false ;
+
+    // no triangle that stays may flip over
+    return !flips( from, to, col.target ) && !flips( to, from, col.target ) ;
+  }
+
+  // does moving vertex v to p flip any of its triangles that don't also have vertex other?
+  bool flips( int v, int other, const Vector3f& p )
+  {
+    for( int t : trisOf( v ) )
+    {
+      if( triDead[t] )  skip ;
+      int* ixs = tri(t) ;
+      if( ixs[0] == other || ixs[1] == other || ixs[2] == other )  skip ; // collapses away
+      Vector3f a = mesh->verts[ ixs[0] ].pos, b = mesh->verts[ ixs[1] ].pos, c = mesh->verts[ ixs[2] ].pos ;
+      Vector3f before = ( b-a ).cross( c-a ) ;
+      if( ixs[0] == v )  a = p ;
+      else if( ixs[1] == v )  b = p ;
+      else  c = p ;
+      Vector3f after = ( b-a ).cross( c-a ) ;
+      if( before.dot( after ) <= 0 )  return true ;
+    }
+    return false ;
+  }
+
+  void collapse( const Collapse& col )
+  {
+    int from = col.from, to = col.to ;
+    for( int t : trisOf( from ) )
+    {
+      if( triDead[t] )  skip ;
+      int* ixs = tri(t) ;
+      if( ixs[0] == to || ixs[1] == to || ixs[2] == to )
+      {
+        triDead[t] = 1 ;
+        liveTris-- ;
+        skip ;
+      }
+      for( int c = 0 ; c < 3 ; c++ )
+        if( ixs[c] == from )
+          ixs[c] = to ;
+    }
+    mesh->indicesChanged() ;
+    vertDead[from] = 1 ;
+
+    VertexPNCT& vTo = mesh->verts[to] ;
+    vTo.pos = col.target ;
+    vTo.normal = mergedNormal( vTo.normal, mesh->verts[from].normal ) ;
+    quadrics[to] += quadrics[from] ;
+    version[to]++ ;
+
+    // from's triangles are to's now: link its rows on after to's,
+    // then drop the dead triangles, packing the live ones into the front rows
+    int tail = to ;
+    while( nextRow[tail] != -1 )  tail = nextRow[tail] ;
+    nextRow[tail] = from ;
+    int wRow = to, wK = 0 ;
+    for( int row = to ; row != -1 ; row = nextRow[row] )
+    {
+      for( int k = 0 ; k < rowLen[row] ; k++ )
+      {
+        int t = vertTris.tris[ vertTris.start[row] + k ] ;
+        if( triDead[t] )  skip ;
+        // (a row is only left once it's full, so writing never gets ahead of reading)
+        while( wK == vertTris.start[wRow+1] - vertTris.start[wRow] )
+        {
+          rowLen[wRow] = wK ;
+          wRow = nextRow[wRow], wK = 0 ;
+        }
+        vertTris.tris[ vertTris.start[wRow] + wK++ ] = t ;
+      }
+    }
+    rowLen[wRow] = wK ;
+    nextRow[wRow] = -1 ; // any rows after are empty now
+
+    // replan all to's edges
+    markStamp++ ;
+    for( int t : trisOf( to ) )
+      for( int c = 0 ; c < 3 ; c++ )
+      {
+        int n = tri(t)[c] ;
+        if( n != to && mark[n] != markStamp )
+        {
+          mark[n] = markStamp ;
+          pushEdge( to, n ) ;
+        }
+      }
+  }
+
+  // Collapses edges cheapest first until at most targetTris triangles are left,
+  // or the cheapest collapse left costs more than maxError (a sum of squared distances
+  // to the original triangles' planes, so roughly maxError^2 ~ how far the surface may move).
+  // beforeCollapse( col ) is called just before each collapse is made, while trisOf( col.from )
+  // still lists the triangles it's about to change.  The triangles stay where they are in
+  // mesh->indices, with the dead ones marked in triDead.  Returns the number of triangles left.
+  template <typename F>
+  int collapseUntil( int targetTris, float maxError, const F& beforeCollapse )
+  {
+    int numVerts = (int)mesh->verts.size() ;
+    int numTris = (int)mesh->indices.size()/3 ;
+
+    // which verts sit on a periodic wall
+    mesh->gatherEdgeData( voxelGrid ) ;
+    locked.resize( numVerts ) ;
+    for( int i = 0 ; i < numVerts ; i++ )
+      locked[i] = !mesh->vertexWallHits[i].empty() ;
+
+    quadrics.assign( numVerts, Quadric() ) ;
+    vertTris = mesh->vertexTriangles() ;
+    rowLen.resize( numVerts ) ;
+    for( int i = 0 ; i < numVerts ; i++ )
+      rowLen[i] = vertTris.start[i+1] - vertTris.start[i] ;
+    nextRow.assign( numVerts, -1 ) ;
+    triDead.assign( numTris, 0 ) ;
+    vertDead.assign( numVerts, 0 ) ;
+    version.assign( numVerts, 0 ) ;
+    mark.assign( numVerts, 0 ) ;
+    markStamp = 0 ;
+    liveTris = numTris ;
+
+    // every edge once, as (lo,hi) packed in a 64 bit key, with how many triangles use it
+    vector<unsigned long long> edges ;
+    edges.reserve( 3*numTris ) ;
+    for( int t = 0 ; t < numTris ; t++ )
+    {
+      int* ixs = tri(t) ;
+      if( ixs[0] == ixs[1] || ixs[0] == ixs[2] || ixs[1] == ixs[2] )
+      {
+        triDead[t] = 1 ;
+        liveTris-- ;
+        skip ;
+      }
+
+      Vector3f a = mesh->verts[ ixs[0] ].pos, b = mesh->verts[ ixs[1] ].pos, c = mesh->verts[ ixs[2] ].pos ;
+      Vector3f n = ( b-a ).cross( c-a ) ;
+      if( n.len2() > 0 )
+      {
+        Quadric plane( n.normalize(), a ) ;
+        for( int k = 0 ; k < 3 ; k++ )
+          quadrics[ ixs[k] ] += plane ;
+      }
+      for( int k = 0 ; k < 3 ; k++ )
+      {
+        unsigned int u = ixs[k], v = ixs[(k+1)%3] ;
+        edges.push_back( (unsigned long long)min( u, v ) << 32 | max( u, v ) ) ;
+      }
+    }
+    sort( edges.begin(), edges.end() ) ;
+
+    for( int e = 0 ; e < edges.size() ; )
+    {
+      int run = 1 ;
+      while( e+run < edges.size() && edges[e+run] == edges[e] )  run++ ;
+      int u = (int)( edges[e] >> 32 ), v = (int)( edges[e] & 0xffffffffu ) ;
+
+      // a boundary edge (a hole, not a wall) gets a plane standing up along it,
+      // so its verts don't wander off the boundary
+      if( run == 1 && !( locked[u] && locked[v] ) )
+      {
+        for( int t : trisOf( u ) )
+        {
+          if( triDead[t] )  skip ;
+          int* ixs = tri(t) ;
+          if( ixs[0] != v && ixs[1] != v && ixs[2] != v )  skip ;
+          Vector3f a = mesh->verts[ ixs[0] ].pos, b = mesh->verts[ ixs[1] ].pos, c = mesh->verts[ ixs[2] ].pos ;
+          Vector3f faceN = ( b-a ).cross( c-a ) ;
+          Vector3f n = ( mesh->verts[v].pos - mesh->verts[u].pos ).cross( faceN ) ;
+          if( n.len2() > 0 )
+          {
+            Quadric plane( n.normalize(), mesh->verts[u].pos ) ;
+            quadrics[u] += plane ;
+            quadrics[v] += plane ;
+          }
+          break ;
+        }
+      }
+
+      pushEdge( u, v ) ;
+      e += run ;
+    }
+
+    float maxCost = maxError*maxError ;
+    while( liveTris > targetTris && !heap.empty() )
+    {
+      Collapse col = heap.top() ;
+      heap.pop() ;
+      if( col.cost > maxCost )  break ;
+      if( vertDead[col.from] || vertDead[col.to] ||
+          version[col.from] != col.fromVersion || version[col.to] != col.toVersion )
+        skip ; // stale
+      if( !canCollapse( col ) )  skip ;
+      beforeCollapse( col ) ;
+      collapse( col ) ;
+    }
+
+    priority_queue<Collapse>().swap( heap ) ;
+    return liveTris ;
+  }
+
+  // collapseUntil, then the dead triangles and verts are dropped (mesh->rebuild()).
+  // Returns the number of triangles left.
+  int decimate( int targetTris, float maxError )
+  {
+    collapseUntil( targetTris, maxError, []( const Collapse& col ) {} ) ;
+
+    // keep the live triangles, then drop the dead verts
+    int numTris = (int)mesh->indices.size()/3 ;
+    vector<int> liveIndices ;
+    liveIndices.reserve( 3*liveTris ) ;
+    for( int t = 0 ; t < numTris ; t++ )
+      if( !triDead[t] )
+        liveIndices.insert( liveIndices.end(), tri(t), tri(t)+3 ) ;
+    mesh->indices.swap( liveIndices ) ;
+    mesh->rebuild() ;
+    return liveTris ;
+  }
+} ;
+
+#endif
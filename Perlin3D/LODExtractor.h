@@ -0,0 +1,319 @@
+#ifndef LODEXTRACTOR_H
+#define LODEXTRACTOR_H
+
+#include "MarchingTets.h"
+
+// Chunked level-of-detail isosurface extraction.
+//
+// The grid is cut into chunks of chunkSize^3 cells.  Each chunk picks a level L
+// (by distance to the eye) and is marched with cells 2^L voxels wide, using
+// marching tets on level L of a mip pyramid of the voxel grid.
+//
+// The pyramid is POINT SAMPLED (level L voxel i is level 0 voxel i*2^L), not averaged.
+// That way every coarse sample IS a fine sample, which is what lets
+// a coarse chunk line up exactly with a finer neighbour.
+//
+// Where a chunk touches a finer chunk, you'd get cracks because the fine side
+// has cut points the coarse side doesn't.  Transvoxel fixes this with special
+// transition cells.  Here the transition cells are coarse cells that
+// are instead tetrahedralized by coning the cell's center to a triangulation of each face:
+//   - a face shared with finer cells uses exactly the finer cells' face triangulation (8 tris)
+//   - a face that has an edge touching finer cells gets that edge split at the midpoint
+//     (fanned from the face center)
+//   - every other face uses the same diagonal marching tets uses
+// So the tets on both sides of every face match and there are no cracks.
+// This needs neighbouring chunks to be at most 1 level apart, which selectLevels() enforces.
+//
+// The grid still WRAPS: chunks on opposite walls are neighbours.
+struct LODExtractor : public IsosurfaceFinder
+{
+  int chunkSize ;     // cells per chunk side, at level 0
+  int numLevels ;     // level 0 is the full res voxel grid
+  Vector3i numChunks ;
+
+  // mips[L-1] is level L of the pyramid. (level 0 is voxelGrid itself)
+  vector<VoxelGrid> mips ;
+
+  vector<int> chunkLevels ;
+
+  LODExtractor( VoxelGrid *iVoxelGrid, vector<VertexPNCT>* iVerts, float iIsosurface, const Vector4f& color,
+    int iChunkSize, int iNumLevels ) :
+    IsosurfaceFinder( iVoxelGrid, iVerts, iIsosurface, color )
+  {
+    chunkSize = iChunkSize ;
+    numLevels = iNumLevels ;
+
+    // A level L cell is 2^L voxels wide, and it has to fit in a chunk a whole number of times.
+    while( numLevels > 1 && chunkSize % (1 << (numLevels-1)) )
+      numLevels-- ;
+
+    const Vector3i& dims = voxelGrid->dims ;
+    if( dims.x % chunkSize || dims.y % chunkSize || dims.z % chunkSize )
+    {
+      error( "LODExtractor: dims (%d,%d,%d) not a multiple of chunkSize %d", dims.x, dims.y, dims.z, chunkSize ) ;
+      numChunks = 0 ;
+      return ;
+    }
+    numChunks = dims / chunkSize ;
+    chunkLevels.resize( numChunks.x*numChunks.y*numChunks.z, 0 ) ;
+
+    buildPyramid() ;
+  }
+
+  VoxelGrid* level( int L )
+  {
+    if( !L )  return voxelGrid ;
+    return &mips[ L-1 ] ;
+  }
+
+  void buildPyramid()
+  {
+    mips.resize( numLevels-1 ) ;
+    for( int L = 1 ; L < numLevels ; L++ )
+    {
+      VoxelGrid *fine = level( L-1 ) ;
+      VoxelGrid &mip = mips[ L-1 ] ;
+      mip.worldSize = fine->worldSize ;
+      mip.dims = fine->dims / 2 ;
+      mip.resize() ; // same worldSize over half the dims, so getP() lands on the same world points
+
+      for( int k = 0 ; k < mip.dims.z ; k++ )
+        for( int j = 0 ; j < mip.dims.y ; j++ )
+          for( int i = 0 ; i < mip.dims.x ; i++ )
+            mip.voxels[ mip.index( i,j,k ) ].v = fine->voxels[ fine->index( 2*i, 2*j, 2*k ) ].v ;
+    }
+  }
+
+  inline int chunkIndex( Vector3i chunk ) const
+  {
+    chunk += numChunks ;
+    chunk %= numChunks ;
+    return chunk.x + chunk.y*numChunks.x + chunk.z*numChunks.x*numChunks.y ;
+  }
+
+  // level of the chunk holding the level 0 cell `cell` (wraps).
+  inline int levelAt( Vector3i cell ) const
+  {
+    voxelGrid->wrappedIndex( cell ) ;
+    return chunkLevels[ chunkIndex( cell / chunkSize ) ] ;
+  }
+
+  // Picks a level for every chunk from its distance to `eye` (in world space).
+  // Chunks closer than lodDistance get full res, and every doubling of
+  // distance past that drops a level.
+  void selectLevels( const Vector3f& eye, float lodDistance )
+  {
+    if( !chunkLevels.size() )  return ;
+
+    float worldSize = voxelGrid->worldSize ;
+    for( int k = 0 ; k < numChunks.z ; k++ )
+    {
+      for( int j = 0 ; j < numChunks.y ; j++ )
+      {
+        for( int i = 0 ; i < numChunks.x ; i++ )
+        {
+          Vector3i chunk( i,j,k ) ;
+          Vector3f center = voxelGrid->getP( chunk*chunkSize + chunkSize/2 ) ;
+
+          // the world repeats, so measure to the NEAREST copy of the chunk
+          Vector3f diff = center - eye ;
+          for( int a = 0 ; a < 3 ; a++ )
+            diff.elts[a] -= worldSize * floorf( diff.elts[a]/worldSize + 0.5f ) ;
+          float dist = diff.len() ;
+
+          int L = 0 ;
+          if( dist > lodDistance )
+            L = 1 + (int)log2f( dist/lodDistance ) ;
+          chunkLevels[ chunkIndex( chunk ) ] = min( L, numLevels-1 ) ;
+        }
+      }
+    }
+
+    // Neighbouring chunks (including across edges & corners) may only differ by 1 level.
+    // Pull levels down until that holds.
+    bool changed = 1 ;
+    while( changed )
+    {
+      changed = 0 ;
+      for( int k = 0 ; k < numChunks.z ; k++ )
+        for( int j = 0 ; j < numChunks.y ; j++ )
+          for( int i = 0 ; i < numChunks.x ; i++ )
+          {
+            int &L = chunkLevels[ chunkIndex( Vector3i( i,j,k ) ) ] ;
+            for( int n = 0 ; n < 27 ; n++ )
+            {
+              Vector3i d( n%3 - 1, (n/3)%3 - 1, n/9 - 1 ) ;
+              int nL = chunkLevels[ chunkIndex( Vector3i( i,j,k ) + d ) ] ;
+              if( L > nL + 1 )
+              {
+                L = nL + 1 ;
+                changed = 1 ;
+              }
+            }
+          }
+    }
+  }
+
+  // A level L cell is a transition cell if any of the 26 cells around it is finer.
+  bool isTransitionCell( const Vector3i& cellMin, int L )
+  {
+    int s = 1 << L ;
+    for( int n = 0 ; n < 27 ; n++ )
+    {
+      Vector3i d( n%3 - 1, (n/3)%3 - 1, n/9 - 1 ) ;
+      if( levelAt( cellMin + d*s ) < L )
+        return 1 ;
+    }
+    return 0 ;
+  }
+
+  // The edge from P going +s along `axis` needs its midpoint if any
+  // of the 4 cells around it is finer than L.
+  bool edgeSplit( const Vector3i& P, int axis, int L )
+  {
+    int s = 1 << L ;
+    Vector3i e1, e2 ;
+    e1[ OTHERAXIS1( axis ) ] = s ;
+    e2[ OTHERAXIS2( axis ) ] = s ;
+    for( int i = 0 ; i < 4 ; i++ )
+      if( levelAt( P - e1*(i&1) - e2*(i>>1) ) < L )
+        return 1 ;
+    return 0 ;
+  }
+
+  // Emits the tet (apex, a, b, c) wound the same way as the 6 tets in MarchingTets::cube()
+  void coneTet( MarchingTets& mt, const Vector3i& apex, const Vector3i& a, const Vector3i& b, const Vector3i& c )
+  {
+    if( (a-apex).dot( (b-apex).cross( c-apex ) ) > 0 )
+      mt.tet( apex, a, c, b ) ;
+    else
+      mt.tet( apex, a, b, c ) ;
+  }
+
+  // Splits square p00,p10,p11,p01 (u,v corners) with the diagonal that marching tets
+  // uses for faces perpendicular to `axis`, coned to apex.
+  void coneSquare( MarchingTets& mt, int axis, const Vector3i& apex,
+    const Vector3i& p00, const Vector3i& p10, const Vector3i& p11, const Vector3i& p01 )
+  {
+    if( axis == 0 )
+    {
+      // x faces split on the 00-11 diagonal (AD in the cube)
+      coneTet( mt, apex, p00, p10, p11 ) ;
+      coneTet( mt, apex, p00, p11, p01 ) ;
+    }
+    else
+    {
+      // y and z faces split on the 10-01 diagonal (BE, CE in the cube)
+      coneTet( mt, apex, p10, p11, p01 ) ;
+      coneTet( mt, apex, p10, p01, p00 ) ;
+    }
+  }
+
+  // cellMin is in level 0 cells.  `mt` runs on level L-1 of the pyramid,
+  // which has all the face centers, edge midpoints and the cell center we need.
+  void transitionCell( MarchingTets& mt, const Vector3i& cellMin, int L )
+  {
+    int s = 1 << L ;
+    Vector3i c = cellMin / (s/2) ; // cell corner in level L-1 voxels. cell is 2 of those wide.
+    Vector3i center = c + 1 ;
+
+    for( int axis = 0 ; axis < 3 ; axis++ )
+    {
+      int u = OTHERAXIS1( axis ), v = OTHERAXIS2( axis ) ;
+      Vector3i eu, ev ;
+      eu[u] = 1 ;
+      ev[v] = 1 ;
+
+      for( int side = 0 ; side < 2 ; side++ )
+      {
+        Vector3i ea ;
+        ea[axis] = 1 ;
+        Vector3i f = c + ea*(2*side) ; // face corner 00 (level L-1)
+
+        // face point at (pu,pv) in 0..2
+        #define FP( pu, pv ) (f + eu*(pu) + ev*(pv))
+
+        // the cell across this face
+        Vector3i across = cellMin + ea*( side ? s : -s ) ;
+        if( levelAt( across ) < L )
+        {
+          // 4 finer squares, each split the way the finer cells split them
+          for( int q = 0 ; q < 4 ; q++ )
+          {
+            int pu = q&1, pv = q>>1 ;
+            coneSquare( mt, axis, center, FP(pu,pv), FP(pu+1,pv), FP(pu+1,pv+1), FP(pu,pv+1) ) ;
+          }
+          skip ;
+        }
+
+        // Which of the 4 face edges touch finer cells?  (in level 0 cells)
+        Vector3i F = cellMin + ea*(side*s) ;
+        Vector3i su = eu*s, sv = ev*s ;
+        bool split[4] = {
+          edgeSplit( F, u, L ),      // (0,0)-(2,0)
+          edgeSplit( F+su, v, L ),   // (2,0)-(2,2)
+          edgeSplit( F+sv, u, L ),   // (2,2)-(0,2)
+          edgeSplit( F, v, L )       // (0,2)-(0,0)
+        } ;
+
+        if( !split[0] && !split[1] && !split[2] && !split[3] )
+        {
+          coneSquare( mt, axis, center, FP(0,0), FP(2,0), FP(2,2), FP(0,2) ) ;
+          skip ;
+        }
+
+        // Fan from the face center around the boundary, picking up the split edge midpoints.
+        Vector3i loop[8] ;
+        int n = 0 ;
+        loop[n++] = FP(0,0) ;  if( split[0] )  loop[n++] = FP(1,0) ;
+        loop[n++] = FP(2,0) ;  if( split[1] )  loop[n++] = FP(2,1) ;
+        loop[n++] = FP(2,2) ;  if( split[2] )  loop[n++] = FP(1,2) ;
+        loop[n++] = FP(0,2) ;  if( split[3] )  loop[n++] = FP(0,1) ;
+        for( int i = 0 ; i < n ; i++ )
+          coneTet( mt, center, FP(1,1), loop[i], loop[(i+1)%n] ) ;
+
+        #undef FP
+      }
+    }
+  }
+
+  void genVizLOD()
+  {
+    for( int ck = 0 ; ck < numChunks.z ; ck++ )
+    {
+      for( int cj = 0 ; cj < numChunks.y ; cj++ )
+      {
+        for( int ci = 0 ; ci < numChunks.x ; ci++ )
+        {
+          Vector3i chunk( ci,cj,ck ) ;
+          int L = chunkLevels[ chunkIndex( chunk ) ] ;
+          int s = 1 << L ;
+
+          MarchingTets mt( level( L ), verts, isosurface, baseColor ) ;
+          MarchingTets mtFine( level( max( L-1, 0 ) ), verts, isosurface, baseColor ) ;
+
+          Vector3i chunkMin = chunk*chunkSize ;
+          for( int k = 0 ; k < chunkSize ; k += s )
+          {
+            for( int j = 0 ; j < chunkSize ; j += s )
+            {
+              for( int i = 0 ; i < chunkSize ; i += s )
+              {
+                Vector3i cellMin = chunkMin + Vector3i( i,j,k ) ;
+
+                // only cells on the chunk's skin can touch another chunk
+                bool skin = !i || !j || !k || i+s == chunkSize || j+s == chunkSize || k+s == chunkSize ;
+                if( L && skin && isTransitionCell( cellMin, L ) )
+                  transitionCell( mtFine, cellMin, L ) ;
+                else
+                  mt.cube( cellMin / s ) ;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+} ;
+
+#endif
@@ -1,140 +1,374 @@
-#ifndef MARCHINGTETS_H
-#define MARCHINGTETS_H
-
-#include "MarchingCommon.h"
-
-struct MarchingTets : public IsosurfaceFinder
-{
-  bool SOLID ;
-
-  MarchingTets( VoxelGrid *iVoxelGrid, vector<VertexPNCT>* iVerts, float iIsosurface, const Vector4f& color ) :
-    IsosurfaceFinder( iVoxelGrid, iVerts, iIsosurface, color )
-  {
-    SOLID=0;
-  }
-
-  void cutTet1Out( const Vector3i& A, const Vector3i& B, const Vector3i& C, const Vector3i& D )
-  {
-    // D is OUT OF SURFACE.
-    // Get the 3 cut points
-    Vector3f cutAD = voxelGrid->getCutPoint( isosurface, A, D ) ;
-    Vector3f cutCD = voxelGrid->getCutPoint( isosurface, C, D ) ;
-    Vector3f cutBD = voxelGrid->getCutPoint( isosurface, B, D ) ;
-
-    if( SOLID )
-      Geometry::triPrism( *verts, voxelGrid->getP(A), voxelGrid->getP(B), voxelGrid->getP(C),
-                          cutAD, cutCD, cutBD, baseColor ) ;
-    else
-      Geometry::addTriWithNormal( *verts, cutAD, cutCD, cutBD, baseColor ) ; // SHOW ONLY THE CUT FACE
-  
-  }
-
-  // ABC wound CCW, D is out.
-  void cutTet2Out( const Vector3i& A, const Vector3i& B, const Vector3i& C, const Vector3i& D )
-  {
-    // C,D is OUT OF SURFACE.
-
-    // Get the 4 cut points
-    Vector3f cutAC = voxelGrid->getCutPoint( isosurface, A, C ) ;
-    Vector3f cutAD = voxelGrid->getCutPoint( isosurface, A, D ) ;
-    Vector3f cutBC = voxelGrid->getCutPoint( isosurface, B, C ) ;
-    Vector3f cutBD = voxelGrid->getCutPoint( isosurface, B, D ) ;
-
-    if( SOLID )
-      Geometry::triPrism( *verts, voxelGrid->getP(B), cutBD, cutBC,   voxelGrid->getP(A), cutAC, cutAD, baseColor ) ;
-    else
-    {
-      Geometry::addTriWithNormal( *verts, cutAC, cutBC, cutBD, baseColor ) ;
-      Geometry::addTriWithNormal( *verts, cutAC, cutBD, cutAD, baseColor ) ;
-    }
-  }
-
-  void cutTet3Out( const Vector3i& A, const Vector3i& B, const Vector3i& C, const Vector3i& D )
-  {
-    // A is in. the rest are out
-    Vector3f cutAB = voxelGrid->getCutPoint( isosurface, A, B ) ;
-    Vector3f cutAC = voxelGrid->getCutPoint( isosurface, A, C ) ;
-    Vector3f cutAD = voxelGrid->getCutPoint( isosurface, A, D ) ;
-
-    if( SOLID )
-    {
-      Geometry::addTet( *verts, voxelGrid->getP(A), cutAB, cutAC, cutAD, baseColor ) ;
-    }
-    else
-      Geometry::addTriWithNormal( *verts, cutAB, cutAD, cutAC, baseColor ) ;
-  }
-
-  void tet( const Vector3i& A, const Vector3i& B, const Vector3i& C, const Vector3i& D )
-  {
-    float vA = (*voxelGrid)( A ).v ;
-    float vB = (*voxelGrid)( B ).v ;
-    float vC = (*voxelGrid)( C ).v ;
-    float vD = (*voxelGrid)( D ).v ;
-  
-    if( inSurface( vA ) && inSurface( vB ) && inSurface( vC ) && inSurface( vD ) )
-    {
-      // REMOVE to just have a shell.
-      //if( !tooDeep( vA ) && tooDeep( vB ) && tooDeep( vC ) && tooDeep( vD ) )
-      //Geometry::addTet( *verts, getP(A), getP(B), getP(C), getP(D), Vector4f( 0,0,1,1 ) ) ;
-    }
-
-    // 3 are in the surface
-    else if( inSurface( vA ) && inSurface( vB ) && inSurface( vC ) )
-      cutTet1Out( A, B, C, D ) ;
-    else if( inSurface( vA ) && inSurface( vD ) && inSurface( vB ) )
-      cutTet1Out( A, D, B, C ) ;
-    else if( inSurface( vB ) && inSurface( vD ) && inSurface( vC ) )
-      cutTet1Out( B, D, C, A ) ;
-    else if( inSurface( vA ) && inSurface( vC ) && inSurface( vD ) )
-      cutTet1Out( A, C, D, B ) ;
-
-    // 2 in
-    else if( inSurface( vA ) && inSurface( vB ) )
-      cutTet2Out( A, B, C, D ) ;
-    // ASSUMING ORDER DOESN'T MATTER.  IF BACKWARDS TURN AROUND.
-    else if( inSurface( vA ) && inSurface( vC ) )
-      cutTet2Out( A, C, D, B ) ;
-    else if( inSurface( vA ) && inSurface( vD ) )
-      cutTet2Out( A, D, B, C ) ;
-    else if( inSurface( vB ) && inSurface( vC ) )
-      cutTet2Out( B, C, A, D ) ;
-    else if( inSurface( vB ) && inSurface( vD ) )
-      cutTet2Out( B, D, C, A ) ;
-    else if( inSurface( vC ) && inSurface( vD ) )
-      cutTet2Out( C, D, A, B ) ;
-  
-    else if( inSurface( vA ) )
-      cutTet3Out( A, B, C, D ) ;
-    else if( inSurface( vB ) )
-      cutTet3Out( B, A, D, C ) ;
-    else if( inSurface( vC ) )
-      cutTet3Out( C, A, B, D ) ;
-    else if( inSurface( vD ) )
-      cutTet3Out( D, B, A, C ) ;
-  }
-
-  void genVizMarchingTets()
-  {
-    for( int k = 0 ; k < voxelGrid->dims.z ; k++ )
-    {
-      for( int j = 0 ; j < voxelGrid->dims.y ; j++ )
-      {
-        for( int i = 0 ; i < voxelGrid->dims.x ; i++ )
-        {
-          Vector3i dex( i,j,k ) ;
-          Vector3i A=dex+Vector3i(0,0,0), B=dex+Vector3i(0,0,1), C=dex+Vector3i(0,1,0), D=dex+Vector3i(0,1,1),
-                   E=dex+Vector3i(1,0,0), F=dex+Vector3i(1,0,1), G=dex+Vector3i(1,1,0), H=dex+Vector3i(1,1,1);
-        
-          tet( A, B, D, E ) ;
-          tet( A, D, C, E ) ;
-          tet( D, G, C, E ) ;
-          tet( D, H, G, E ) ;
-          tet( B, F, D, E ) ;
-          tet( F, H, D, E ) ;
-        }
-      }
-    }
-  }
-} ;
-
+#ifndef MARCHINGTETS_H
+#define MARCHINGTETS_H
+
+#include "MarchingCommon.h"
+
+// Tables for the indexed version of marching tets (genVizMarchingTets( indices )).
+// Cube corners are numbered z + 2*y + 4*x, the same as MarchingCubes' pts:
+//    C----G
+//   /|   /|
+//  D-A--H E
+//  |/   |/
+//  B----F
+// A=0, B=1, C=2, D=3, E=4, F=5, G=6, H=7.
+
+// The 6 tets cube() splits a cube into, in the same order and winding.
+static int cubeTets[6][4] = {
+  { 0,1,3,4 }, // A B D E
+  { 0,3,2,4 }, // A D C E
+  { 3,6,2,4 }, // D G C E
+  { 3,7,6,4 }, // D H G E
+  { 1,5,3,4 }, // B F D E
+  { 5,7,3,4 }  // F H D E
+} ;
+
+// The 6 edges of a tet ABCD: AB AC AD BC BD CD
+static int tetEdges[6][2] = { {0,1},{0,2},{0,3},{1,2},{1,3},{2,3} } ;
+
+// The surface tris for each of the 16 in/out cases of a tet ABCD, as tetEdges indices, -1 terminated.
+// The case number has bit 1 set if A is in, 2 for B, 4 for C, 8 for D.
+// These are exactly the tris (and winding) tet()'s if-chain makes.
+static int tetTris[16][7] = {
+  { -1 },                // 0: all out
+  { 0,2,1, -1 },         // 1: A in
+  { 0,3,4, -1 },         // 2: B in
+  { 1,3,4, 1,4,2, -1 },  // 3: A B in
+  { 1,5,3, -1 },         // 4: C in
+  { 2,5,3, 2,3,0, -1 },  // 5: A C in
+  { 0,1,5, 0,5,4, -1 },  // 6: B C in
+  { 2,5,4, -1 },         // 7: D out
+  { 4,5,2, -1 },         // 8: D in
+  { 0,4,5, 0,5,1, -1 },  // 9: A D in
+  { 3,5,2, 3,2,0, -1 },  // 10: B D in
+  { 1,3,5, -1 },         // 11: C out
+  { 1,2,4, 1,4,3, -1 },  // 12: C D in
+  { 0,4,3, -1 },         // 13: B out
+  { 0,1,2, -1 },         // 14: A out
+  { -1 }                 // 15: all in
+} ;
+
+// The 7 kinds of grid edge the tets use, as the 2 cube corners they join when "anchored" at A:
+// the x, y, z axis edges, the 3 face diagonals (AD, BE, CE) and the DE body diagonal.
+// Each of the 19 edges in a cube (12 cube edges, 6 face diagonals, DE) is one of these
+// anchored at one of the cube's corners, and it's the same edge the neighbouring cubes see.
+static int edgeTypes[7][2] = { {0,4},{0,2},{0,1}, {0,3},{1,4},{2,4}, {3,4} } ;
+
+// Where the per-tet marching tets output goes (everything but the indexed genVizMarchingTets).
+// This is the default: render-ready tris into a vertex array.
+// Any other sink just needs the same 3 functions (and wholeTets).
+struct TriSoupSink
+{
+  // In Solid mode, should tets that are ALL inside the surface be output?
+  // For display no, they're only hidden inner faces.
+  static const bool wholeTets = false ;
+
+  vector<VertexPNCT> *verts ;
+
+  TriSoupSink( vector<VertexPNCT>* iVerts ) : verts( iVerts ) { }
+
+  // a piece of the isosurface
+  void tri( const Vector3f& A, const Vector3f& B, const Vector3f& C, const Vector4f& color ) {
+    Geometry::addTriWithNormal( *verts, A, B, C, color ) ;
+  }
+  // the solid pieces (Solid mode only)
+  void tet( const Vector3f& A, const Vector3f& B, const Vector3f& C, const Vector3f& D, const Vector4f& color ) {
+    Geometry::addTet( *verts, A, B, C, D, color ) ;
+  }
+  // ABC is one end of the prism and DEF the other, wound the other way,
+  // so the side edges are A-D, B-F and C-E (see Geometry::triPrism)
+  void prism( const Vector3f& A, const Vector3f& B, const Vector3f& C,
+              const Vector3f& D, const Vector3f& E, const Vector3f& F, const Vector4f& color ) {
+    Geometry::triPrism( *verts, A, B, C, D, E, F, color ) ;
+  }
+} ;
+
+// Marching tets, specialized at compile time on:
+//   Solid: make the solid pieces of each tet that are inside the surface (prisms and tets)
+//          instead of just the surface tris.  (This used to be a runtime bool, SOLID,
+//          checked in every cutTet*Out() even though it never changes during a march.)
+//   Sink:  where the output goes, see TriSoupSink.
+// The MarchingTets / SolidMarchingTets typedefs at the bottom output to a vertex array.
+template <bool Solid, typename Sink>
+struct MarchingTetsT : public IsosurfaceFinder
+{
+  Sink sink ;
+
+  // For the indexed version: which (anchor corner, edge type) each tet edge is,
+  // stored as anchor*7 + type.
+  int tetEdgeSlot[6][6] ;
+
+  // The vertex index of each (anchor voxel, edge type), -1 for not made yet,
+  // for 2 layers of anchors: edgeCache[0] at z=k, edgeCache[1] at z=k+1 (while marching layer k).
+  // Anchors run 0..dims on x and y: the +walls get their own verts (like the unindexed version does).
+  vector<int> edgeCache[2] ;
+
+  // Output to the vertex array iVerts, through Sink( iVerts ).
+  MarchingTetsT( VoxelGrid *iVoxelGrid, vector<VertexPNCT>* iVerts, float iIsosurface, const Vector4f& color ) :
+    IsosurfaceFinder( iVoxelGrid, iVerts, iIsosurface, color ), sink( iVerts )
+  {
+    initEdgeSlots() ;
+  }
+
+  // Output to any sink (verts isn't set, so the indexed genVizMarchingTets can't be used).
+  MarchingTetsT( VoxelGrid *iVoxelGrid, const Sink& iSink, float iIsosurface, const Vector4f& color ) :
+    IsosurfaceFinder( iVoxelGrid, 0, iIsosurface, color ), sink( iSink )
+  {
+    initEdgeSlots() ;
+  }
+
+  void initEdgeSlots()
+  {
+    // Match each tet edge to an edge type + anchor.
+    for( int t = 0 ; t < 6 ; t++ )
+    {
+      for( int e = 0 ; e < 6 ; e++ )
+      {
+        Vector3i a = corner( cubeTets[t][ tetEdges[e][0] ] ), b = corner( cubeTets[t][ tetEdges[e][1] ] ) ;
+        tetEdgeSlot[t][e] = -1 ;
+        for( int anchor = 0 ; anchor < 8 ; anchor++ )
+        {
+          for( int type = 0 ; type < 7 ; type++ )
+          {
+            Vector3i p0 = corner( anchor ) + corner( edgeTypes[type][0] ),
+                     p1 = corner( anchor ) + corner( edgeTypes[type][1] ) ;
+            if( ( p0 == a && p1 == b ) || ( p0 == b && p1 == a ) )
+              tetEdgeSlot[t][e] = anchor*7 + type ;
+          }
+        }
+      }
+    }
+  }
+
+  inline static Vector3i corner( int i )
+  {
+    return Vector3i( (i>>2)&1, (i>>1)&1, i&1 ) ;
+  }
+
+  void cutTet1Out( const Vector3i& A, const Vector3i& B, const Vector3i& C, const Vector3i& D )
+  {
+    // D is OUT OF SURFACE.
+    // Get the 3 cut points
+    Vector3f cutAD = voxelGrid->getCutPoint( isosurface, A, D ) ;
+    Vector3f cutCD = voxelGrid->getCutPoint( isosurface, C, D ) ;
+    Vector3f cutBD = voxelGrid->getCutPoint( isosurface, B, D ) ;
+
+    if( Solid )
+      sink.prism( voxelGrid->getP(A), voxelGrid->getP(B), voxelGrid->getP(C),
+                  cutAD, cutCD, cutBD, baseColor ) ;
+    else
+      sink.tri( cutAD, cutCD, cutBD, baseColor ) ; // SHOW ONLY THE CUT FACE
+  
+  }
+
+  // ABC wound CCW, D is out.
+  void cutTet2Out( const Vector3i& A, const Vector3i& B, const Vector3i& C, const Vector3i& D )
+  {
+    // C,D is OUT OF SURFACE.
+
+    // Get the 4 cut points
+    Vector3f cutAC = voxelGrid->getCutPoint( isosurface, A, C ) ;
+    Vector3f cutAD = voxelGrid->getCutPoint( isosurface, A, D ) ;
+    Vector3f cutBC = voxelGrid->getCutPoint( isosurface, B, C ) ;
+    Vector3f cutBD = voxelGrid->getCutPoint( isosurface, B, D ) ;
+
+    if( Solid )
+      sink.prism( voxelGrid->getP(B), cutBD, cutBC,   voxelGrid->getP(A), cutAC, cutAD, baseColor ) ;
+    else
+    {
+      sink.tri( cutAC, cutBC, cutBD, baseColor ) ;
+      sink.tri( cutAC, cutBD, cutAD, baseColor ) ;
+    }
+  }
+
+  void cutTet3Out( const Vector3i& A, const Vector3i& B, const Vector3i& C, const Vector3i& D )
+  {
+    // A is in. the rest are out
+    Vector3f cutAB = voxelGrid->getCutPoint( isosurface, A, B ) ;
+    Vector3f cutAC = voxelGrid->getCutPoint( isosurface, A, C ) ;
+    Vector3f cutAD = voxelGrid->getCutPoint( isosurface, A, D ) ;
+
+    if( Solid )
+    {
+      sink.tet( voxelGrid->getP(A), cutAB, cutAC, cutAD, baseColor ) ;
+    }
+    else
+      sink.tri( cutAB, cutAD, cutAC, baseColor ) ;
+  }
+
+  void tet( const Vector3i& A, const Vector3i& B, const Vector3i& C, const Vector3i& D )
+  {
+    float vA = (*voxelGrid)( A ).v ;
+    float vB = (*voxelGrid)( B ).v ;
+    float vC = (*voxelGrid)( C ).v ;
+    float vD = (*voxelGrid)( D ).v ;
+  
+    if( inSurface( vA ) && inSurface( vB ) && inSurface( vC ) && inSurface( vD ) )
+    {
+      if( Solid && Sink::wholeTets )
+        sink.tet( voxelGrid->getP(A), voxelGrid->getP(B), voxelGrid->getP(C), voxelGrid->getP(D), baseColor ) ;
+
+      // REMOVE to just have a shell.
+      //if( !tooDeep( vA ) && tooDeep( vB ) && tooDeep( vC ) && tooDeep( vD ) )
+      //Geometry::addTet( *verts, getP(A), getP(B), getP(C), getP(D), Vector4f( 0,0,1,1 ) ) ;
+    }
+
+    // 3 are in the surface
+    else if( inSurface( vA ) && inSurface( vB ) && inSurface( vC ) )
+      cutTet1Out( A, B, C, D ) ;
+    else if( inSurface( vA ) && inSurface( vD ) && inSurface( vB ) )
+      cutTet1Out( A, D, B, C ) ;
+    else if( inSurface( vB ) && inSurface( vD ) && inSurface( vC ) )
+      cutTet1Out( B, D, C, A ) ;
+    else if( inSurface( vA ) && inSurface( vC ) && inSurface( vD ) )
+      cutTet1Out( A, C, D, B ) ;
+
+    // 2 in
+    else if( inSurface( vA ) && inSurface( vB ) )
+      cutTet2Out( A, B, C, D ) ;
+    // ASSUMING ORDER DOESN'T MATTER.  IF BACKWARDS TURN AROUND.
+    else if( inSurface( vA ) && inSurface( vC ) )
+      cutTet2Out( A, C, D, B ) ;
+    else if( inSurface( vA ) && inSurface( vD ) )
+      cutTet2Out( A, D, B, C ) ;
+    else if( inSurface( vB ) && inSurface( vC ) )
+      cutTet2Out( B, C, A, D ) ;
+    else if( inSurface( vB ) && inSurface( vD ) )
+      cutTet2Out( B, D, C, A ) ;
+    else if( inSurface( vC ) && inSurface( vD ) )
+      cutTet2Out( C, D, A, B ) ;
+  
+    else if( inSurface( vA ) )
+      cutTet3Out( A, B, C, D ) ;
+    else if( inSurface( vB ) )
+      cutTet3Out( B, A, D, C ) ;
+    else if( inSurface( vC ) )
+      cutTet3Out( C, A, B, D ) ;
+    else if( inSurface( vD ) )
+      cutTet3Out( D, B, A, C ) ;
+  }
+
+  // Splits the cube at dex into 6 tets that all share the DE diagonal.
+  // Every face of the cube gets split by the same diagonal as the
+  // matching face of the neighbouring cube, so the tets tile space.
+  //    C----G
+  //   /|   /|
+  //  D-A--H E
+  //  |/   |/
+  //  B----F
+  void cube( const Vector3i& dex )
+  {
+    Vector3i A=dex+Vector3i(0,0,0), B=dex+Vector3i(0,0,1), C=dex+Vector3i(0,1,0), D=dex+Vector3i(0,1,1),
+             E=dex+Vector3i(1,0,0), F=dex+Vector3i(1,0,1), G=dex+Vector3i(1,1,0), H=dex+Vector3i(1,1,1);
+  
+    tet( A, B, D, E ) ;
+    tet( A, D, C, E ) ;
+    tet( D, G, C, E ) ;
+    tet( D, H, G, E ) ;
+    tet( B, F, D, E ) ;
+    tet( F, H, D, E ) ;
+  }
+
+  // Gets the vertex on edge e of tet t of the cube at (i,j,k),
+  // making it if neither this cube nor a neighbour has already.
+  int edgeVertex( int t, int e, int i, int j, const Vector3i* pts, const float* vals )
+  {
+    int slot = tetEdgeSlot[t][e] ;
+    Vector3i anchor = corner( slot/7 ) ;
+    int &vi = edgeCache[ anchor.z ][ ( (j+anchor.y)*(voxelGrid->dims.x+1) + i+anchor.x )*7 + slot%7 ] ;
+    if( vi == -1 )
+    {
+      // always cut from the lower corner, so the point is the same whichever cube makes it
+      int a = cubeTets[t][ tetEdges[e][0] ], b = cubeTets[t][ tetEdges[e][1] ] ;
+      if( a > b )  swap( a, b ) ;
+      float tAB = unlerp( isosurface, vals[a], vals[b] ) ;
+      vi = (int)verts->size() ;
+      verts->push_back( VertexPNCT( Vector3f::lerp( tAB, voxelGrid->getP( pts[a] ), voxelGrid->getP( pts[b] ) ), Vector3f(), baseColor ) ) ;
+    }
+    return vi ;
+  }
+
+  // Indexed marching tets (surface only, so not for Solid).
+  // Same tets and tris as genVizMarchingTets(), but:
+  //   - the cube's 8 corners are fetched once, not 4 times for each of the 6 tets
+  //   - each tet's case comes out of tetTris instead of an if-chain
+  //   - each cut point is made ONCE and shared (through edgeCache) by every tri
+  //     that uses it, in this cube and the neighbouring ones
+  // verts get area weighted normals from the tris around them.
+  void genVizMarchingTets( vector<int>& indices )
+  {
+    static_assert( !Solid, "the indexed marching tets only makes the surface" ) ;
+    const Vector3i& dims = voxelGrid->dims ;
+    int layerSize = (dims.x+1)*(dims.y+1)*7 ;
+    edgeCache[0].assign( layerSize, -1 ) ;
+    edgeCache[1].assign( layerSize, -1 ) ;
+    int firstVert = (int)verts->size() ;
+
+    Vector3i pts[8] ;
+    float vals[8] ;
+    for( int k = 0 ; k < dims.z ; k++ )
+    {
+      for( int j = 0 ; j < dims.y ; j++ )
+      {
+        for( int i = 0 ; i < dims.x ; i++ )
+        {
+          int inMask = 0 ;
+          for( int c = 0 ; c < 8 ; c++ )
+          {
+            pts[c] = Vector3i( i,j,k ) + corner( c ) ;
+            vals[c] = (*voxelGrid)( pts[c] ).v ;
+            if( inSurface( vals[c] ) )  inMask |= 1<<c ;
+          }
+          if( !inMask || inMask == 255 )  skip ; // no tet in this cube is cut
+
+          for( int t = 0 ; t < 6 ; t++ )
+          {
+            int caseNo = 0 ;
+            for( int c = 0 ; c < 4 ; c++ )
+              caseNo |= ( (inMask >> cubeTets[t][c]) & 1 ) << c ;
+
+            for( const int* e = tetTris[caseNo] ; *e != -1 ; e += 3 )
+            {
+              int v0 = edgeVertex( t, e[0], i,j, pts, vals ),
+                  v1 = edgeVertex( t, e[1], i,j, pts, vals ),
+                  v2 = edgeVertex( t, e[2], i,j, pts, vals ) ;
+              indices.push_back( v0 ) ;  indices.push_back( v1 ) ;  indices.push_back( v2 ) ;
+
+              // unnormalized, so bigger tris count for more (same direction as Triangle::triNormal)
+              Vector3f &a = (*verts)[v0].pos, &b = (*verts)[v1].pos, &c = (*verts)[v2].pos ;
+              Vector3f n = ( a - b ).cross( c - b ) ;
+              (*verts)[v0].normal += n ;  (*verts)[v1].normal += n ;  (*verts)[v2].normal += n ;
+            }
+          }
+        }
+      }
+
+      // layer k+1's anchors are layer k+2's bottom
+      edgeCache[0].swap( edgeCache[1] ) ;
+      edgeCache[1].assign( layerSize, -1 ) ;
+    }
+
+    for( int i = firstVert ; i < verts->size() ; i++ )
+      if( !(*verts)[i].normal.allzero() )
+        (*verts)[i].normal.normalize() ;
+  }
+
+  void genVizMarchingTets()
+  {
+    for( int k = 0 ; k < voxelGrid->dims.z ; k++ )
+    {
+      for( int j = 0 ; j < voxelGrid->dims.y ; j++ )
+      {
+        for( int i = 0 ; i < voxelGrid->dims.x ; i++ )
+        {
+          Vector3i dex( i,j,k ) ;
+          cube( dex ) ;
+        }
+      }
+    }
+  }
+} ;
+
+typedef MarchingTetsT<false, TriSoupSink> MarchingTets ;
+typedef MarchingTetsT<true, TriSoupSink> SolidMarchingTets ;
+
 #endif
\ No newline at end of file
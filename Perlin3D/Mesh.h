@@ -1,491 +1,753 @@
-#ifndef MESH_H
-#define MESH_H
-
-#include "Vectorf.h"
-#include <vector>
-using namespace std ;
-
-Vector4f AxisEdgeColors[] = {
-  Vector4f(1,0,0,1), Vector4f(1,0,0,1),
-  Vector4f(0,1,0,1), Vector4f(0,1,0,1),
-  Vector4f(0,0,1,1), Vector4f(0,0,1,1)
-} ;
-
-struct Mesh
-{
-  // Final array of vertices output by program (to draw)
-  vector<VertexPNCT> verts ;
-  vector<int> indices ;
-
-  int renderMode ;
-
-  Mesh()
-  {
-    renderMode = GL_TRIANGLES ; //default is triangles.
-  }
-
-  void createIndexBuffer()
-  {
-    vector<VertexPNCT> iVerts ;
-
-    // now smooth the normals.
-    iVerts.clear() ;
-    
-    // first I merge into an index buffer.
-    for( int i = 0 ; i < verts.size() ; i++ )
-    {
-      int jindex = -1 ;
-      for( int j = 0 ; j < iVerts.size() && jindex==-1 ; j++ )
-        if( iVerts[j].pos.isNear( verts[i].pos, EPS ) )
-          jindex = j ; // verts[i] already exists at jindex
-    
-      if( jindex==-1 )
-      {
-        iVerts.push_back( verts[i] ) ; // another vertex
-        indices.push_back( (int)iVerts.size() - 1 ) ;  // 
-      }
-      else
-      {
-        iVerts[jindex].normal += verts[i].normal ;
-        indices.push_back( jindex ) ; // there is another index.
-      }
-    }
-    
-    // now fix the merged normals.
-    for( int i = 0 ; i < iVerts.size() ; i++ )
-      iVerts[i].normal.normalize() ;
-    
-    verts.swap( iVerts ) ;
-  }
-
-  void rebuild()
-  {
-    vector<VertexPNCT> rebuiltiVerts ;
-    vector<int> rebuiltIndices ;
-  
-    // if its not referenced it gets left out of the rebuild
-    // if it is DEGENERATE then it gets left out of the rebuild.
-    // Go in 3's, test the tri for degeneracy (by checking if 2 indices are equal).
-    for( int indexNo = 0 ; indexNo < indices.size() ; indexNo+=3 )
-    {
-      int ixs[3] = { indices[indexNo], indices[indexNo+1], indices[indexNo+2] } ;
-      // If any of them are the same, SKIP/LEAVE OUT because its a degenerate face.
-      if( ixs[0] == ixs[1] || ixs[0] == ixs[2] || ixs[1] == ixs[2] )  skip ;
-
-      // Triangle Ok.  process each index individually.
-      for( int iNo=0 ; iNo < 3 ; iNo++ )
-      {
-        int jindex = -1 ;
-      
-        // Look for a vertex near iVerts[indices[i]]
-        for( int j = 0 ; j < rebuiltiVerts.size() && jindex==-1 ; j++ )
-          if( rebuiltiVerts[j].pos.isNear( verts[ ixs[iNo] ].pos ) )
-            jindex = j ; // iVerts[ indices[i] ] already exists at jindex
-    
-        if( jindex==-1 )
-        {
-          rebuiltiVerts.push_back( verts[ ixs[iNo] ] ) ; // another vertex
-          rebuiltIndices.push_back( (int)rebuiltiVerts.size() - 1 ) ;  // 
-        }
-        else
-        {
-          //rebuiltiVerts[jindex].normal += iVerts[ indices[i] ].normal ;
-          rebuiltIndices.push_back( jindex ) ; // there is another index just into this same vertex
-        }
-      }
-    }
-
-    verts.swap( rebuiltiVerts ) ;
-    indices.swap( rebuiltIndices ) ;
-
-  }
-  
-  // Count of how many times each vertex hit an edge.
-  // parallel array of NEIGHBOUR structure, tells you:
-  // WHAT EDGE YOU'RE ON (if you are on an edge)
-  // and WHO YOUR NEIGHBOUR IS
-  // Neighbour is actually a bad name for this structure
-  // more like Isopoint or SamePoint -- the LAST PT on the mesh
-  // is exactly the same as the 1st pt, only translated +worldSize in x,y, or z
-  vector< vector<int> > vertexWallHits ; // the numbers are WHICH EDGE you hit.
-  vector< vector<int> > wallToVertexHits ; // maps PX=>list of verts on that edge.
-  vector< vector<int> > vNeighbours ; // MAPS a vertex to the vertex indices that it TOUCHES
-  // on the "other side".  CORNERS touch more than 1 vertex on more than 1 axis.
-  
-  // The voxelGrid object is needed only for getting WALL values
-  void gatherEdgeData( VoxelGrid *voxelGrid )
-  {
-    wallToVertexHits.clear() ;
-    vertexWallHits.clear() ;
-    vNeighbours.clear() ;
-    
-    wallToVertexHits.resize( 6 ) ;
-    vertexWallHits.resize( verts.size() ) ;
-    vNeighbours.resize( verts.size() ) ;
-    
-    // Every vertex..
-    for( int i = 0 ; i < verts.size() ; i++ )
-    {
-      // ..test proximity to ALL 6 walls (PX wall, NX wall, .. NZ wall)
-      for( int j = 0 ; j < 6 ; j++ )
-      {
-        int axis=j/2; // PX=0,NX=1, so both map to index 0 (x-axis)
-        
-        //int neg=j%2 ; // negative axes (NX,NY,NZ) are the odd ones (1,3,5).
-        //float worldEdge = (-2*neg + 1) * worldSize/2.f ; 
-        float worldEdge = voxelGrid->wallValue( j ) ; // get the world edge for axis j
-        
-        // Now I'm going to test if this vertex is near the
-        // PX,NX, wall (whatever wall j is)
-        if( isNear( verts[i].pos.elts[axis], worldEdge, EPS ) )
-        {
-          // It is, so vertex i is on axis j.
-          // "clean up" the edges by making it not just NEAR the world edge, but
-          // exactly equal to the world edge on that axis.
-          verts[i].pos.elts[axis] = worldEdge ;
-          
-          // Now remember that vertex i is on wall j
-          vertexWallHits[i].push_back( j ) ;
-          
-          // store the reverse mapping as well
-          wallToVertexHits[j].push_back( i ) ;  // wall j has vertex i
-          
-          // Can't find neighbour easily until ALL verts processed, it's faster to find
-          // neighbours using the vertexWallHits collection.
-        }
-      }
-    }
-    
-    
-    bool showEdgeColors = 0 ;
-    
-    // Loudly shows you vertex neighbour finding errors in pink on black.
-    // Actually shows that the errors are quite rare and don't produce very big holes!
-    bool showErrors = 0 ;
-    
-    vector<int> errs ;
-    // every vertex..
-    for( int i = 0 ; i < verts.size() ; i++ )
-    {
-      // what walls is vertex `i` on?
-      if( vertexWallHits[i].size() ) // could be 1 (edge), 2 (corner) or even 3 walls (absolute world corner points)
-      {
-        // change the color.
-        if( showEdgeColors )  verts[i].color = Black ;
-
-        // may be more than 1 wall:
-        //for( int j = 0 ; j < vertexWallHits[i].size() ; j++ ) {
-          //int axisEdge = vertexWallHits[i][j] ;
-        for( int axisEdge : vertexWallHits[i] ) {
-          if( showEdgeColors )  verts[i].color.xyz() += AxisEdgeColors[axisEdge].xyz() ;
-        
-          // get the vertex that neighbours this one on the repeated section
-          int axis = axisEdge/2;
-          int oAxis1 = OTHERAXIS1( axis ) ;
-          int oAxis2 = OTHERAXIS2( axis ) ;
-
-          int neg = axisEdge%2 ; // negative axes are the odd ones 1,3,5.
-          int sign = -2*neg + 1 ; // 0=>+1, 1=>-1
-          //float axisOffset = sign * worldSize ;  // to move from NX wall to PX, for example,
-          // you ADD axisOffset (+worldSize) to elts[axis].
-          // so (x,y,z) => (x+worldSize,y,z).
-          
-          // Check the elements on the OPPOSITE wall
-          // To get the opposite walls:
-          // EVEN: add one 0(PX)=>1(NX).  ODD: subtract one.  3(NY)=>2(PY)
-          int oppositeWall = axisEdge + sign ;
-          
-          //float worldEdge = voxelGrid->wallValue( axisEdge ) ; // get the world edge for axisEdge
-        
-          // search the elements in the opposite wall for a vertex that matches mine
-          // (this is much more efficient than searching ALL vertices!)
-          for( int owv : wallToVertexHits[oppositeWall] )
-          {
-            // owv: oppositeWallVertexIndex
-            
-            // to check owi is my neighbour, move that opposite wall pt TO MY WALL,
-            // and check if verts[i]==oppositeWallPt
-            ////Vector3f oppositeWallPt = verts[owv].pos ;
-            ////oppositeWallPt.elts[axis] = worldEdge ; // If I slam your axis to my side,
-            // are you the same as me?  If yes, we are neighbours.
-            ////if( verts[i].pos.isNear( oppositeWallPt, EPS ) )
-            ////  vNeighbours[i].push_back( owv ) ;  // These are "touching" at the wrap point
-            
-            // OR you could just compare THE OTHER 2 AXES.
-            if( isNear( verts[owv].pos.elts[oAxis1], verts[i].pos.elts[oAxis1], EPS ) &&
-                isNear( verts[owv].pos.elts[oAxis2], verts[i].pos.elts[oAxis2], EPS ) )
-              vNeighbours[i].push_back( owv ) ;  // These are "touching" at the wrap point
-            
-          }
-        }
-        
-        // Sanity check.  I should have 
-        if( vNeighbours[i].size() != vertexWallHits[i].size() )
-        {
-          // This happens if a break was introduced in the mesh
-          //printf( "ERROR: vNeighbours[%d].size()(%lu) != vertexWallHits[%d].size()(%lu).\n",
-          //  i, vNeighbours[i].size(), i, vertexWallHits[i].size() ) ;
-          //verts[i].color = Magenta ; // errors shown below
-          errs.push_back( i ) ;
-          
-          // Ok, if it couldn't find a neighbour, don't consider it a vertex wall hit then.
-          // This keeps the error from compounding, especially if marching cubes produced
-          // a mesh with one of these errors in it to begin with (which it sometimes does)
-          for( int wall : vertexWallHits[ i ] )
-            for( int j = 0 ; j < wallToVertexHits[wall].size() ; j++ )
-              if( wallToVertexHits[wall][j] == i )
-                wallToVertexHits[wall].erase( wallToVertexHits[wall].begin() + j ) ;
-            
-          vertexWallHits[ i ].clear() ;
-          
-        }
-      }
-    } // end every vertex
-    
-    if( errs.size() ) {
-      printf( "%lu vertices didn't find neighbour-friends :(\n"
-        //"This happens because a neighbour was decimated in a previous stage merge.\n"
-        //"This just means your mesh has a (probably) small hole/discontinuity.\n"
-        //"Turn on `showErrors` in the code to see where the problem is.\n",
-        , errs.size() ) ;
-      
-      if( showErrors )
-      {
-        for( int i = 0 ; i < verts.size() ; i++ )
-          verts[i].color = Black ;
-        for( int i = 0 ; i < errs.size() ; i++ )
-          verts[errs[i]].color = Magenta ;
-      }
-      
-    }
-  }
-  
-  /// Make the edge normals continuous and smooth
-  void smoothEdgeNormals()
-  {
-    // This DOES visit each vertex pair twice, but to no ill effect.
-    for( int i = 0 ; i < vNeighbours.size() ; i++ )
-    {
-      for( int neighbour : vNeighbours[i] )
-      {
-        verts[i].normal += verts[neighbour].normal ;
-      }
-      
-      //if( vNeighbours[i].size() == 2 )  verts[i].color = Yellow ; // show we detect corners properly
-      //else if( vNeighbours[i].size() == 3 )  verts[i].color = White ; // rare total corner
-      
-      verts[i].normal.normalize() ;
-      //verts[i].color = verts[i].color = Vector4f::random() ; // ensure it is behaving correctly
-    }
-  }
-  
-private:
-  // basically set ALL use of i2=i1.
-  inline void changeUseOf( int i1, int i2 )
-  {
-    // EVERYBODY that used i2 now uses i1.  i2 is discarded.
-    for( int j = 0 ; j < indices.size() ; j++ )
-      if( indices[j] == i2 )
-        indices[j]=i1 ;
-    
-    // Any vertex that had i2 as a neighbour no longer has i2 as a neighbour
-    for( int i = 0 ; i < vNeighbours.size() ; i++ )
-      for( int j = 0 ; j < vNeighbours[i].size() ; j++ )
-        if( vNeighbours[i][j] == i2 )
-          vNeighbours[i].erase( vNeighbours[i].begin() + j ) ;  ///these are small arrays so the performance hit is small
-  }
-  
-  // Merges 2 indices into 1 vertex, COLLAPSING AN EDGE.
-  // the vertices at i1 and i2 merge to the geometric center between them
-  inline void mergeToCenter( int i1, int i2 )
-  {
-    // get new avg value
-    Vector3f newPt = ( verts[i1].pos + verts[i2].pos ) / 2 ;
-    Vector3f newNormal = ( verts[i1].normal + verts[i2].normal ).normalize() ;
-    
-    verts[i1].pos=newPt;
-    verts[i1].normal=newNormal;
-    
-    changeUseOf( i1, i2 ) ;
-  }
-  
-  // merges i2 into i1.
-  inline void mergeToFirst( int i1, int i2 )
-  {
-    // Avg the normal, but DO NOT move i1's pos
-    verts[i1].normal = ( verts[i1].normal + verts[i2].normal ).normalize() ;
-    changeUseOf( i1, i2 ) ;
-  }
-  
-  
-
-public:
-  // "smooths" the mesh by removing small EDGES
-  // first it creates the index buffer, then it works from there
-  // to eliminate short edges.
-  void smoothMesh( VoxelGrid *voxelGrid, float minEdgeLength )
-  {
-    createIndexBuffer() ;
-    gatherEdgeData( voxelGrid ) ;
-    
-    // If you want to smooth edge normals before actual mesh smoothing, it must be done here.
-    smoothEdgeNormals() ;
-    
-    // Now we can downsample the mesh.
-    // You can only merge EDGES.
-    // attempt to reduce small triangles to degeneracy (actually sharing all 3 pts)
-    for( int indexNo = 0 ; indexNo < indices.size() ; indexNo+=3 )
-    {
-      // 3 edges per tri (group of 3 verts)
-      for( int eNo=0 ; eNo < 3 ; eNo++ )
-      {
-        // [0,1], [1,2], [2,0]
-        int i1 = indices[indexNo + eNo] ;
-        int i2 = indices[indexNo + (eNo+1)%3] ;
-        
-        // let i1 be the "higher degree" index (one with more neighbours)
-        if( vertexWallHits[i2].size() > vertexWallHits[i1].size() )
-        {
-          swap( i1, i2 ) ;
-        }
-        
-        Vector3f a=verts[i1].pos, b=verts[i2].pos;
-        Vector3f edge = a-b ;
-      
-        // tolerance is the max size edge to collapse
-        if( edge.len() < minEdgeLength )
-        {
-          // If the number of wall hits is EQUAL (which maxes out at 3), use
-          // an averaging of the vertices.
-          if( vertexWallHits[i1].size() == vertexWallHits[i2].size() )
-          {
-            // MUST BE from the same wall.
-            bool sameWall=1;
-            for( int wall : vertexWallHits[i1] )
-            {
-              if( !contains( vertexWallHits[i2], wall ) )
-              {
-                // Cannot allow this type of merge.
-                //printf( "The two vertices share the same # walls (%ld), BUT THE WALL "
-                //  "VERTEX i1 IS ON (%d) IS NOT SHARED BY i2. Thus these vertices cannot merge.\n",
-                //  vertexWallHits[i1].size(), wall ) ;
-                //verts[i1].color = Magenta ;
-                sameWall=0;
-                break ;
-              }
-            }
-            
-            // Not the same wall.  Skip the merge.
-            if( !sameWall ) skip ;
-            
-            // You do the same thing for #edge wall hits=0,1,2.
-            mergeToCenter( i1, i2 ) ;
-
-            // in case it IS an edge vertex,
-            // We force a merge on all other sides to happen NOW
-            // because it's possible that for the repeat side,
-            // some internal edges will merge FIRST, before that
-            // repeat side gets a chance to, creating holes.
-            if( vNeighbours[i1].size() == vNeighbours[i2].size() ) // this is NOT true when there's ALREADY a hole in the mesh
-            {
-              for( int n = 0 ; n < vNeighbours[i1].size() ; n++ )
-              {
-                // do a regular edge merge for ni1, ni2.
-                int ni1=vNeighbours[i1][n],ni2=vNeighbours[i2][n] ;
-                //verts[ni1].color = Green ;
-                
-                // This prevents breaks from being introduced in the mesh
-                mergeToCenter( ni1, ni2 ) ;
-              }
-            }
-          }
-          else if( vertexWallHits[i1].size() > vertexWallHits[i2].size() )
-          {
-            // merge towards HIGHER DEGREE edge (we made degree i1 always > degree i2 w/swap above).
-            mergeToFirst( i1, i2 ) ;
-            
-          }
-        }
-      }
-    }
-
-    // Don't bother smoothing edge normals until downsampling is over
-    gatherEdgeData( voxelGrid ) ;
-    smoothEdgeNormals() ;
-    
-    // You need to REBUILD the mesh now becaue the deleted vertices
-    // that are never references STILL TAKE UP SPACES.  deleting them
-    // shifts the array, so changes ALL the indices after the deleted elt.
-    rebuild() ;
-
-    //printf( "%d vertices converted to %d vertices and %d indices\n", verts.size(), iVerts.size(), indices.size() ) ;
-  }
-
-  void texture()
-  {
-    // Here I will create a very large GL texture.
-    // 3D perlin noise will be used to generate the values here.
-
-    // (not done)
-  }
-  
-  
-  // Generates per-vertex colors using perlin noise and a cubic spline
-  // also generates texcoords for procedural detail tex
-  void vertexTexture( float wTexture, int wTexturePeriod, const Vector3f& worldSize, int textureRepeats )
-  {
-    // this makes the texture repeat (textureRepeats) times across the world
-    Vector2f texScale = Vector2f(textureRepeats) / worldSize.xy() ;
-    
-    for( int i = 0 ; i < verts.size() ; i++ )
-    {
-      Vector3f sp = verts[i].pos ;
-      
-      //sp.normalize() ;
-      sp /= worldSize ;
-      
-      // The color comes out of the perlin noise mapping from the 3-space position,
-      // so it varies smoothly in 3 space.
-      //float n = Perlin::pnoise( sinf(sp.x), cosf(2*sp.y), sp.z, tw.x, 2,2,2,2 ) ;
-      //float n = Perlin::pnoise( sinf(2*M_PI*sp.x), cosf(2*M_PI*sp.y), sp.z, tw.x, 2,2,1,8 ) ;
-      float n = Perlin::pnoise( sp.x, sp.y, sp.z, wTexture, 1,1,1,wTexturePeriod ) ;
-
-      //Vector3f color(
-      //  Perlin::noise( sp.x, sp.y, sp.z, tw.x ),
-      //  Perlin::noise( sp.x, sp.y, sp.z, tw.y ),
-      //  Perlin::noise( sp.x, sp.y, sp.z, tw.z )
-      //) ;
-      Vector3f color = Vector3f::cubicSpline( n, Vector3f( 0.45,0.34,0.54 ),
-        Vector3f( 0.87,0.1,0 ),
-        Vector3f( 0.66,0.24,0.2 ),
-        Vector3f( 0.55,0.21,0.1 )
-      ) ;
-      
-      // Negative color is undefined
-      color.fabs() ;
-
-      // No extreme colors
-      //color.clampLen( 0.45f, 0.65f ) ;
-      
-      // Give each vertex this uniqueish smooth color
-      verts[i].color.xyz() = color ;
-      
-      
-      
-      // Figure out a reasonable tiling on the surface.
-      verts[i].tex = Vector2f( randInt(0, 2), randInt( 0, 2 ) ) ;
-      
-      
-
-      
-      //verts[i].tex = Vector2f::random() ;
-      verts[i].tex = verts[i].pos.xy() * texScale ; 
-      //verts[i].tex.fabs() ;
-    }
-  }
-  
-  
-} ;
-
-
+#ifndef MESH_H
+#define MESH_H
+
+#include "Vectorf.h"
+#include "SpatialHash.h"
+#include "VertexTriangles.h"
+#include <vector>
+using namespace std ;
+
+// The vertex attributes Mesh::vertexTexture can fill in, as bits
+enum VertexAttribs { AttribColor = 1, AttribTexCoord = 2, AttribAll = AttribColor | AttribTexCoord } ;
+
+Vector4f AxisEdgeColors[] = {
+  Vector4f(1,0,0,1), Vector4f(1,0,0,1),
+  Vector4f(0,1,0,1), Vector4f(0,1,0,1),
+  Vector4f(0,0,1,1), Vector4f(0,0,1,1)
+} ;
+
+// Up to 3 ints kept in place: a vertex is on at most 3 walls (1 per axis),
+// and has 1 periodic twin per wall, so Mesh's per-vertex wall data is flat arrays of these.
+struct WallSlots
+{
+  int count ;
+  int elts[3] ;
+
+  WallSlots() : count( 0 ) {}
+  inline void push_back( int v ) { if( count < 3 )  elts[count++] = v ; }
+  inline void clear() { count = 0 ; }
+  inline int size() const { return count ; }
+  inline bool empty() const { return !count ; }
+  inline int operator[]( int i ) const { return elts[i] ; }
+  inline const int* begin() const { return elts ; }
+  inline const int* end() const { return elts + count ; }
+  inline bool contains( int v ) const {
+    for( int i = 0 ; i < count ; i++ )
+      if( elts[i] == v )  return true ;
+    return false ;
+  }
+} ;
+
+// The working arrays of Mesh's passes (the weld, rebuild(), the wall twins, smoothMesh) and
+// of optimizeMesh.  Each Mesh owns 1, so the arrays keep their capacity from 1 regen to the next
+// without being shared between meshes, and release() gives the memory back.
+// verts and indices are the other halves of double buffers: a pass fills them and swaps them
+// with the mesh's own, so between passes they hold the arrays from before.
+// Copying a MeshScratch copies nothing, it's only the capacity.
+struct MeshScratch
+{
+  vector<VertexPNCT> verts ; // createIndexBuffer's welded verts, rebuild()'s kept verts
+  vector<int> indices ;      // rebuild()'s and the optimizer passes' new indices
+
+  // createIndexBuffer
+  vector<int> weldTo ; // the index of the kept vertex verts[i] welds to
+  vector<Vector3f> pts ;
+  SpatialHash hash ;
+  vector<int> firstNear, newIndex ;
+
+  // rebuild
+  vector<int> remap ; // old vertex index => rebuilt index (-1 if unused)
+
+  // gatherEdgeData
+  vector<int> wallVerts[6] ;
+  vector<Vector3f> wallPts[6] ;
+  SpatialHash wallHash[6] ;
+  vector<WallSlots> numTwins ;
+  vector<int> errs ;
+
+  // smoothMesh
+  vector<int> neighbours1, neighbours2 ;
+
+  // ForsythOptimizer::optimize
+  vector<int> vertTris, trisLeft, cachePos ;
+  vector<float> vScore, tScore ;
+  vector<char> emitted ;
+
+  // optimizeOverdraw
+  vector<int> clusterStart, cachedAt, order ;
+  vector<float> facing ;
+
+  MeshScratch() {}
+  MeshScratch( const MeshScratch& ) {}
+  MeshScratch& operator=( const MeshScratch& ) { return *this ; }
+
+  void release()
+  {
+    freeVector( verts ) ;
+    freeVector( indices ) ;
+    freeVector( weldTo ) ;
+    freeVector( pts ) ;
+    hash.release() ;
+    freeVector( firstNear ) ;
+    freeVector( newIndex ) ;
+    freeVector( remap ) ;
+    for( int wall = 0 ; wall < 6 ; wall++ )
+    {
+      freeVector( wallVerts[wall] ) ;
+      freeVector( wallPts[wall] ) ;
+      wallHash[wall].release() ;
+    }
+    freeVector( numTwins ) ;
+    freeVector( errs ) ;
+    freeVector( neighbours1 ) ;
+    freeVector( neighbours2 ) ;
+    freeVector( vertTris ) ;
+    freeVector( trisLeft ) ;
+    freeVector( cachePos ) ;
+    freeVector( vScore ) ;
+    freeVector( tScore ) ;
+    freeVector( emitted ) ;
+    freeVector( clusterStart ) ;
+    freeVector( cachedAt ) ;
+    freeVector( order ) ;
+    freeVector( facing ) ;
+  }
+} ;
+
+struct Mesh
+{
+  // Final array of vertices output by program (to draw)
+  vector<VertexPNCT> verts ;
+  vector<int> indices ;
+
+  int renderMode ;
+
+  MeshScratch scratch ; // the passes' working arrays, see MeshScratch
+
+  // Debug colors gatherEdgeData puts on the verts (these replace the vertexTexture colors):
+  // showEdgeColors colors the wall verts by the walls they're on, and showErrors loudly shows
+  // you vertex neighbour finding errors in pink on black.  (It actually shows that the errors
+  // are quite rare and don't produce very big holes!)
+  bool showEdgeColors, showErrors ;
+
+  Mesh()
+  {
+    renderMode = GL_TRIANGLES ; //default is triangles.
+    showEdgeColors = showErrors = 0 ;
+    indicesVersion = 1 ;
+    vertTrisVersion = 0 ;
+    for( int j = 0 ; j < 7 ; j++ )
+      wallStart[j] = 0 ;
+  }
+
+  // calls f( j ) for every j < i with verts[j] isNear p (p is verts[i].pos, and hash is built over the verts' positions)
+  template <typename F>
+  static void forEarlierNear( const SpatialHash& hash, int i, const Vector3f& p, const F& f )
+  {
+    Vector3i lo = hash.cellOf( p - EPS ), hi = hash.cellOf( p + EPS ) ;
+    float r2 = 3*EPS*EPS ; // the corner of the EPS box
+    for( int z = lo.z ; z <= hi.z ; z++ )
+      for( int y = lo.y ; y <= hi.y ; y++ )
+        hash.forRow( lo.x, hi.x, y, z, p, r2, [&]( int j, float d2, const Vector3f& q ) {
+          if( j < i && q.isNear( p, EPS ) )
+            f( j ) ;
+        } ) ;
+  }
+
+  // Welds verts (a triangle soup) into unique verts + indices.
+  // A vertex joins the first kept vertex that isNear it (within EPS on every axis),
+  // or is kept itself if there isn't one, and the normals of welded verts are summed.
+  // The near verts are found through a SpatialHash with cells a few EPS across,
+  // so each vertex only looks at the 1 or 2 cells it's within EPS of on each axis.
+  //
+  // The temporaries here, in rebuild() and in gatherEdgeData() are in scratch, so once the sizes
+  // have settled a regen doesn't go back to the heap for them.
+  void createIndexBuffer()
+  {
+    int n = (int)verts.size() ;
+    vector<int>& weldTo = scratch.weldTo ;
+    weldTo.assign( n, -1 ) ;
+
+    if( EPS > 0 )
+    {
+      vector<Vector3f>& pts = scratch.pts ;
+      pts.resize( n ) ;
+      parallelFor( n, [&]( int i ) {
+        pts[i] = verts[i].pos ;
+      } ) ;
+      SpatialHash& hash = scratch.hash ;
+      hash.build( pts, 8*EPS ) ;
+
+      // The earliest vertex near each vertex (or -1), all at once.
+      // Going through them in the hash's order keeps the lookups local.
+      vector<int>& firstNear = scratch.firstNear ;
+      firstNear.resize( n ) ;
+      parallelFor( n, [&]( int e ) {
+        int i = hash.entries[e] ;
+        int first = -1 ;
+        forEarlierNear( hash, i, hash.entryPts[e], [&]( int j ) {
+          if( first == -1 || j < first )  first = j ;
+        } ) ;
+        firstNear[i] = first ;
+      } ) ;
+
+      // Then in order, like the 1-by-1 weld would: when the earliest near vertex
+      // was kept, that's the one.  Only when it got welded to something else itself
+      // (near verts chained further than EPS) do the near verts get searched again.
+      for( int i = 0 ; i < n ; i++ )
+      {
+        int j = firstNear[i] ;
+        if( j == -1 )  skip ;
+        if( weldTo[j] == -1 )
+          weldTo[i] = j ;
+        else
+        {
+          int kept = -1 ;
+          forEarlierNear( hash, i, pts[i], [&]( int k ) {
+            if( weldTo[k] == -1 && ( kept == -1 || k < kept ) )  kept = k ;
+          } ) ;
+          weldTo[i] = kept ;
+        }
+      }
+    }
+
+    // kept verts keep their order
+    vector<int>& newIndex = scratch.newIndex ;
+    newIndex.resize( n ) ;
+    int numKept = 0 ;
+    for( int i = 0 ; i < n ; i++ )
+      if( weldTo[i] == -1 )
+        newIndex[i] = numKept++ ;
+    for( int i = 0 ; i < n ; i++ )
+      if( weldTo[i] != -1 )
+        newIndex[i] = newIndex[ weldTo[i] ] ;
+
+    vector<VertexPNCT>& iVerts = scratch.verts ; // swapped with verts, so the 2 buffers take turns
+    iVerts.resize( numKept ) ;
+    parallelFor( n, [&]( int i ) {
+      if( weldTo[i] == -1 )
+        iVerts[ newIndex[i] ] = verts[i] ;
+    } ) ;
+    for( int i = 0 ; i < n ; i++ )
+      if( weldTo[i] != -1 )
+        iVerts[ newIndex[i] ].normal += verts[i].normal ;
+
+    // now fix the merged normals.
+    parallelFor( numKept, [&]( int i ) {
+      iVerts[i].normal.normalize() ;
+    } ) ;
+
+    indices.insert( indices.end(), newIndex.begin(), newIndex.end() ) ;
+    verts.swap( iVerts ) ;
+    indicesChanged() ;
+  }
+
+  // Drops the degenerate triangles and the verts nothing uses any more.
+  // The verts left are renumbered in the order the triangles first use them.
+  // Merged verts already share 1 index, so this is just a remap table over the indices.
+  void rebuild()
+  {
+    vector<int>& remap = scratch.remap ;
+    remap.assign( verts.size(), -1 ) ;
+    vector<int>& rebuiltIndices = scratch.indices ; // (swapped with indices, like the verts)
+    rebuiltIndices.clear() ;
+    rebuiltIndices.reserve( indices.size() ) ;
+    int numRebuilt = 0 ;
+  
+    // if its not referenced it gets left out of the rebuild
+    // if it is DEGENERATE then it gets left out of the rebuild.
+    // Go in 3's, test the tri for degeneracy (by checking if 2 indices are equal).
+    for( int indexNo = 0 ; indexNo < indices.size() ; indexNo+=3 )
+    {
+      int ixs[3] = { indices[indexNo], indices[indexNo+1], indices[indexNo+2] } ;
+      // If any of them are the same, SKIP/LEAVE OUT because its a degenerate face.
+      if( ixs[0] == ixs[1] || ixs[0] == ixs[2] || ixs[1] == ixs[2] )  skip ;
+
+      // Triangle Ok.  the first time a vertex is used, it gets the next rebuilt index
+      for( int iNo=0 ; iNo < 3 ; iNo++ )
+      {
+        int& r = remap[ ixs[iNo] ] ;
+        if( r == -1 )
+          r = numRebuilt++ ;
+        rebuiltIndices.push_back( r ) ;
+      }
+    }
+
+    vector<VertexPNCT>& rebuiltiVerts = scratch.verts ;
+    rebuiltiVerts.resize( numRebuilt ) ;
+    parallelFor( (int)verts.size(), [&]( int i ) {
+      if( remap[i] != -1 )
+        rebuiltiVerts[ remap[i] ] = verts[i] ;
+    } ) ;
+
+    verts.swap( rebuiltiVerts ) ;
+    indices.swap( rebuiltIndices ) ;
+    indicesChanged() ;
+  }
+
+  // Which triangles use each vertex, built the first time something asks after the indices change.
+  // Whatever writes indices (or swaps verts for a different set) calls indicesChanged() after,
+  // which bumps indicesVersion, and vertTris is rebuilt when it was built for an older version.
+  VertexTriangles vertTris ;
+  unsigned int indicesVersion ;
+  unsigned int vertTrisVersion ; // the indicesVersion vertTris was built for
+
+  inline void indicesChanged() { indicesVersion++ ; }
+  inline bool vertexTrianglesBuilt() const { return vertTrisVersion == indicesVersion ; }
+
+  const VertexTriangles& vertexTriangles()
+  {
+    if( !vertexTrianglesBuilt() )
+    {
+      vertTris.build( indices, (int)verts.size() ) ;
+      vertTrisVersion = indicesVersion ;
+    }
+    return vertTris ;
+  }
+  
+  // Count of how many times each vertex hit an edge.
+  // parallel array of NEIGHBOUR structure, tells you:
+  // WHAT EDGE YOU'RE ON (if you are on an edge)
+  // and WHO YOUR NEIGHBOUR IS
+  // Neighbour is actually a bad name for this structure
+  // more like Isopoint or SamePoint -- the LAST PT on the mesh
+  // is exactly the same as the 1st pt, only translated +worldSize in x,y, or z
+  vector<WallSlots> vertexWallHits ; // the numbers are WHICH EDGE you hit.
+  vector<int> wallToVertexHits ; // the verts on PX, then the verts on NX, .. then NZ.
+  int wallStart[7] ; // wall j's verts are wallToVertexHits[ wallStart[j] .. wallStart[j+1] )
+  vector<WallSlots> vNeighbours ; // MAPS a vertex to the vertex indices that it TOUCHES
+  // on the "other side".  CORNERS touch more than 1 vertex on more than 1 axis.
+  // vNeighbours[i][n] is the twin across wall vertexWallHits[i][n].
+  
+  // The voxelGrid object is needed only for getting WALL values
+  void gatherEdgeData( VoxelGrid *voxelGrid )
+  {
+    int numVerts = (int)verts.size() ;
+    vertexWallHits.assign( numVerts, WallSlots() ) ;
+    vNeighbours.assign( numVerts, WallSlots() ) ;
+    
+    // Every vertex..
+    parallelFor( numVerts, [&]( int i ) {
+      // ..test proximity to ALL 6 walls (PX wall, NX wall, .. NZ wall)
+      for( int j = 0 ; j < 6 ; j++ )
+      {
+        int axis=j/2; // PX=0,NX=1, so both map to index 0 (x-axis)
+        
+        float worldEdge = voxelGrid->wallValue( j ) ; // get the world edge for axis j
+        
+        // Now I'm going to test if this vertex is near the
+        // PX,NX, wall (whatever wall j is)
+        if( isNear( verts[i].pos.elts[axis], worldEdge, EPS ) )
+        {
+          // It is, so vertex i is on axis j.
+          // "clean up" the edges by making it not just NEAR the world edge, but
+          // exactly equal to the world edge on that axis.
+          verts[i].pos.elts[axis] = worldEdge ;
+          
+          // Now remember that vertex i is on wall j
+          vertexWallHits[i].push_back( j ) ;
+        }
+      }
+    } ) ;
+
+    // store the reverse mapping as well (wall j has vertex i), in vertex order
+    vector<int>* wallVerts = scratch.wallVerts ;
+    for( int wall = 0 ; wall < 6 ; wall++ )
+      wallVerts[wall].clear() ;
+    for( int i = 0 ; i < numVerts ; i++ )
+      for( int wall : vertexWallHits[i] )
+        wallVerts[wall].push_back( i ) ;
+
+    // Each wall's verts, hashed by their 2 coordinates ON the wall, so the twin of a vertex
+    // is found by looking up where it lands on the opposite wall.
+    vector<Vector3f>* wallPts = scratch.wallPts ;
+    SpatialHash* wallHash = scratch.wallHash ;
+    for( int wall = 0 ; wall < 6 ; wall++ )
+    {
+      int axis = wall/2 ;
+      int oAxis1 = OTHERAXIS1( axis ), oAxis2 = OTHERAXIS2( axis ) ;
+      wallPts[wall].resize( wallVerts[wall].size() ) ;
+      for( int k = 0 ; k < wallVerts[wall].size() ; k++ )
+      {
+        const Vector3f& p = verts[ wallVerts[wall][k] ].pos ;
+        wallPts[wall][k] = Vector3f( p.elts[oAxis1], p.elts[oAxis2], 0 ) ;
+      }
+      wallHash[wall].build( wallPts[wall], 8*EPS ) ;
+    }
+
+    // For every wall a vertex is on: how many verts on the opposite wall match it
+    // on the other 2 axes, and the first of them.
+    vector<WallSlots>& numTwins = scratch.numTwins ;
+    numTwins.assign( numVerts, WallSlots() ) ;
+    parallelFor( numVerts, [&]( int i ) {
+      for( int axisEdge : vertexWallHits[i] )
+      {
+        // get the vertex that neighbours this one on the repeated section
+        int axis = axisEdge/2;
+        int oAxis1 = OTHERAXIS1( axis ) ;
+        int oAxis2 = OTHERAXIS2( axis ) ;
+
+        int neg = axisEdge%2 ; // negative axes are the odd ones 1,3,5.
+        int sign = -2*neg + 1 ; // 0=>+1, 1=>-1
+        
+        // Check the elements on the OPPOSITE wall
+        // To get the opposite walls:
+        // EVEN: add one 0(PX)=>1(NX).  ODD: subtract one.  3(NY)=>2(PY)
+        int oppositeWall = axisEdge + sign ;
+        const SpatialHash& hash = wallHash[oppositeWall] ;
+
+        // compare THE OTHER 2 AXES.
+        Vector3f p( verts[i].pos.elts[oAxis1], verts[i].pos.elts[oAxis2], 0 ) ;
+        Vector3i lo = hash.cellOf( p - Vector3f( EPS, EPS, 0 ) ), hi = hash.cellOf( p + Vector3f( EPS, EPS, 0 ) ) ;
+        int found = 0, twin = -1 ;
+        for( int y = lo.y ; y <= hi.y ; y++ )
+          hash.forRow( lo.x, hi.x, y, 0, p, 2*EPS*EPS, [&]( int k, float d2, const Vector3f& q ) {
+            if( isNear( q.x, p.x, EPS ) && isNear( q.y, p.y, EPS ) )
+            {
+              int owv = wallVerts[oppositeWall][k] ; // owv: oppositeWallVertexIndex
+              if( !found || owv < twin )  twin = owv ;
+              found++ ;
+            }
+          } ) ;
+        numTwins[i].push_back( found ) ;
+        vNeighbours[i].push_back( twin ) ;  // These are "touching" at the wrap point
+      }
+    } ) ;
+    
+    vector<int>& errs = scratch.errs ;
+    errs.clear() ;
+    // every vertex, in order, because a vertex that's dropped off the walls below
+    // can't be the twin of any vertex after it
+    for( int i = 0 ; i < numVerts ; i++ )
+    {
+      // what walls is vertex `i` on?
+      if( vertexWallHits[i].size() ) // could be 1 (edge), 2 (corner) or even 3 walls (absolute world corner points)
+      {
+        // change the color.
+        if( showEdgeColors )
+        {
+          verts[i].color = Black ;
+          for( int axisEdge : vertexWallHits[i] )
+            verts[i].color.xyz() += AxisEdgeColors[axisEdge].xyz() ;
+        }
+        
+        // Sanity check.  I should have exactly 1 twin across each wall I'm on
+        bool ok = 1 ;
+        for( int n = 0 ; n < vertexWallHits[i].size() ; n++ )
+        {
+          int twin = vNeighbours[i][n] ;
+          if( numTwins[i][n] != 1 || ( twin < i && vertexWallHits[twin].empty() ) )
+            ok = 0 ;
+        }
+        if( !ok )
+        {
+          // This happens if a break was introduced in the mesh
+          errs.push_back( i ) ;
+          
+          // Ok, if it couldn't find a neighbour, don't consider it a vertex wall hit then.
+          // This keeps the error from compounding, especially if marching cubes produced
+          // a mesh with one of these errors in it to begin with (which it sometimes does)
+          vertexWallHits[ i ].clear() ;
+          vNeighbours[ i ].clear() ;
+        }
+      }
+    } // end every vertex
+
+    wallToVertexHits.clear() ;
+    for( int wall = 0 ; wall < 6 ; wall++ )
+    {
+      wallStart[wall] = (int)wallToVertexHits.size() ;
+      for( int i : wallVerts[wall] )
+        if( !vertexWallHits[i].empty() )
+          wallToVertexHits.push_back( i ) ;
+    }
+    wallStart[6] = (int)wallToVertexHits.size() ;
+    
+    if( errs.size() ) {
+      printf( "%lu vertices didn't find neighbour-friends :(\n"
+        //"This happens because a neighbour was decimated in a previous stage merge.\n"
+        //"This just means your mesh has a (probably) small hole/discontinuity.\n"
+        //"Turn on `showErrors` in the code to see where the problem is.\n",
+        , errs.size() ) ;
+      
+      if( showErrors )
+      {
+        for( int i = 0 ; i < verts.size() ; i++ )
+          verts[i].color = Black ;
+        for( int i = 0 ; i < errs.size() ; i++ )
+          verts[errs[i]].color = Magenta ;
+      }
+      
+    }
+  }
+  
+  /// Make the edge normals continuous and smooth
+  void smoothEdgeNormals()
+  {
+    // This DOES visit each vertex pair twice, but to no ill effect.
+    for( int i = 0 ; i < vNeighbours.size() ; i++ )
+    {
+      for( int neighbour : vNeighbours[i] )
+      {
+        verts[i].normal += verts[neighbour].normal ;
+      }
+      
+      //if( vNeighbours[i].size() == 2 )  verts[i].color = Yellow ; // show we detect corners properly
+      //else if( vNeighbours[i].size() == 3 )  verts[i].color = White ; // rare total corner
+      
+      verts[i].normal.normalize() ;
+      //verts[i].color = verts[i].color = Vector4f::random() ; // ensure it is behaving correctly
+    }
+  }
+  
+private:
+  // While smoothMesh collapses edges, merged verts are tracked as a union-find forest:
+  // mergedInto[i]==i while vertex i is still in use, otherwise it points towards
+  // the vertex that took its place.  The indices are only rewritten once, at the end.
+  vector<int> mergedInto ;
+
+  // the vertex that i has been merged into (i itself if it hasn't been merged)
+  inline int findMerged( int i )
+  {
+    while( mergedInto[i] != i )
+    {
+      mergedInto[i] = mergedInto[ mergedInto[i] ] ; // path halving
+      i = mergedInto[i] ;
+    }
+    return i ;
+  }
+
+  // basically set ALL use of i2=i1.
+  inline void changeUseOf( int i1, int i2 )
+  {
+    // EVERYBODY that used i2 now uses i1.  i2 is discarded.
+    // (i2 drops out of everyone's vNeighbours too, see liveNeighbours)
+    mergedInto[i2] = i1 ;
+  }
+
+  // vNeighbours[i], leaving out the verts that have been merged away
+  inline void liveNeighbours( int i, vector<int>& out ) const
+  {
+    out.clear() ;
+    for( int neighbour : vNeighbours[i] )
+      if( mergedInto[neighbour] == neighbour )
+        out.push_back( neighbour ) ;
+  }
+  
+  // Merges 2 indices into 1 vertex, COLLAPSING AN EDGE.
+  // the vertices at i1 and i2 merge to the geometric center between them
+  inline void mergeToCenter( int i1, int i2 )
+  {
+    // get new avg value
+    Vector3f newPt = ( verts[i1].pos + verts[i2].pos ) / 2 ;
+    Vector3f newNormal = ( verts[i1].normal + verts[i2].normal ).normalize() ;
+    
+    verts[i1].pos=newPt;
+    verts[i1].normal=newNormal;
+    
+    changeUseOf( i1, i2 ) ;
+  }
+  
+  // merges i2 into i1.
+  inline void mergeToFirst( int i1, int i2 )
+  {
+    // Avg the normal, but DO NOT move i1's pos
+    verts[i1].normal = ( verts[i1].normal + verts[i2].normal ).normalize() ;
+    changeUseOf( i1, i2 ) ;
+  }
+  
+  
+
+public:
+  // "smooths" the mesh by removing small EDGES
+  // first it creates the index buffer (unless the mesh came out indexed already),
+  // then it works from there to eliminate short edges.
+  void smoothMesh( VoxelGrid *voxelGrid, float minEdgeLength )
+  {
+    if( !indices.size() )
+      createIndexBuffer() ;
+    gatherEdgeData( voxelGrid ) ;
+    
+    // If you want to smooth edge normals before actual mesh smoothing, it must be done here.
+    smoothEdgeNormals() ;
+    
+    // Now we can downsample the mesh.
+    // You can only merge EDGES.
+    // attempt to reduce small triangles to degeneracy (actually sharing all 3 pts)
+    mergedInto.resize( verts.size() ) ;
+    for( int i = 0 ; i < verts.size() ; i++ )
+      mergedInto[i] = i ;
+    vector<int>& neighbours1 = scratch.neighbours1 ;
+    vector<int>& neighbours2 = scratch.neighbours2 ;
+    for( int indexNo = 0 ; indexNo < indices.size() ; indexNo+=3 )
+    {
+      // 3 edges per tri (group of 3 verts)
+      for( int eNo=0 ; eNo < 3 ; eNo++ )
+      {
+        // [0,1], [1,2], [2,0]
+        int i1 = findMerged( indices[indexNo + eNo] ) ;
+        int i2 = findMerged( indices[indexNo + (eNo+1)%3] ) ;
+        if( i1 == i2 )  skip ; // already collapsed
+        
+        // let i1 be the "higher degree" index (one with more neighbours)
+        if( vertexWallHits[i2].size() > vertexWallHits[i1].size() )
+        {
+          swap( i1, i2 ) ;
+        }
+        
+        Vector3f a=verts[i1].pos, b=verts[i2].pos;
+        Vector3f edge = a-b ;
+      
+        // tolerance is the max size edge to collapse
+        if( edge.len() < minEdgeLength )
+        {
+          // If the number of wall hits is EQUAL (which maxes out at 3), use
+          // an averaging of the vertices.
+          if( vertexWallHits[i1].size() == vertexWallHits[i2].size() )
+          {
+            // MUST BE from the same wall.
+            bool sameWall=1;
+            for( int wall : vertexWallHits[i1] )
+            {
+              if( !vertexWallHits[i2].contains( wall ) )
+              {
+                // Cannot allow this type of merge.
+                //printf( "The two vertices share the same # walls (%ld), BUT THE WALL "
+                //  "VERTEX i1 IS ON (%d) IS NOT SHARED BY i2. Thus these vertices cannot merge.\n",
+                //  vertexWallHits[i1].size(), wall ) ;
+                //verts[i1].color = Magenta ;
+                sameWall=0;
+                break ;
+              }
+            }
+            
+            // Not the same wall.  Skip the merge.
+            if( !sameWall ) skip ;
+            
+            // You do the same thing for #edge wall hits=0,1,2.
+            mergeToCenter( i1, i2 ) ;
+
+            // in case it IS an edge vertex,
+            // We force a merge on all other sides to happen NOW
+            // because it's possible that for the repeat side,
+            // some internal edges will merge FIRST, before that
+            // repeat side gets a chance to, creating holes.
+            liveNeighbours( i1, neighbours1 ) ;
+            liveNeighbours( i2, neighbours2 ) ;
+            if( neighbours1.size() == neighbours2.size() ) // this is NOT true when there's ALREADY a hole in the mesh
+            {
+              for( int n = 0 ; n < neighbours1.size() ; n++ )
+              {
+                // do a regular edge merge for ni1, ni2.
+                int ni1=neighbours1[n],ni2=neighbours2[n] ;
+                if( ni1 == ni2 )  skip ;
+                //verts[ni1].color = Green ;
+                
+                // This prevents breaks from being introduced in the mesh
+                mergeToCenter( ni1, ni2 ) ;
+              }
+            }
+          }
+          else if( vertexWallHits[i1].size() > vertexWallHits[i2].size() )
+          {
+            // merge towards HIGHER DEGREE edge (we made degree i1 always > degree i2 w/swap above).
+            mergeToFirst( i1, i2 ) ;
+            
+          }
+        }
+      }
+    }
+
+    // everybody that used a merged vertex now uses the one it merged into
+    for( int i = 0 ; i < verts.size() ; i++ )
+      mergedInto[i] = findMerged( i ) ;
+    parallelFor( (int)indices.size(), [&]( int j ) {
+      indices[j] = mergedInto[ indices[j] ] ;
+    } ) ;
+    indicesChanged() ;
+    mergedInto.clear() ;
+
+    // Don't bother smoothing edge normals until downsampling is over
+    gatherEdgeData( voxelGrid ) ;
+    smoothEdgeNormals() ;
+    
+    // You need to REBUILD the mesh now becaue the deleted vertices
+    // that are never references STILL TAKE UP SPACES.  deleting them
+    // shifts the array, so changes ALL the indices after the deleted elt.
+    rebuild() ;
+
+    //printf( "%d vertices converted to %d vertices and %d indices\n", verts.size(), iVerts.size(), indices.size() ) ;
+  }
+
+  void texture()
+  {
+    // Here I will create a very large GL texture.
+    // 3D perlin noise will be used to generate the values here.
+
+    // (not done)
+  }
+  
+  
+  // the colors are the debug colors, so vertexTexture shouldn't color over them
+  bool debugColors() const { return showEdgeColors || showErrors ; }
+
+  // Generates per-vertex colors using perlin noise and a cubic spline
+  // also generates texcoords for procedural detail tex.
+  // attribs says which of the 2 to fill in (only what's going to read the mesh needs them),
+  // and the rest of each vertex is left as it is.  Each is its own parallel pass over the verts:
+  // the texcoords are just a scale of pos.xy, so that one's a flat loop the compiler vectorizes.
+  void vertexTexture( float wTexture, int wTexturePeriod, const Vector3f& worldSize, int textureRepeats, int attribs=AttribAll )
+  {
+    vertexTexture( verts, wTexture, wTexturePeriod, worldSize, textureRepeats, attribs ) ;
+  }
+
+  // The same on any verts (the progressive mesh's are colored the same way)
+  static void vertexTexture( vector<VertexPNCT>& verts, float wTexture, int wTexturePeriod, const Vector3f& worldSize, int textureRepeats, int attribs )
+  {
+    int numVerts = (int)verts.size() ;
+    if( attribs & AttribColor )
+    {
+      parallelFor( numVerts, [&]( int i ) {
+        Vector3f sp = verts[i].pos ;
+
+        //sp.normalize() ;
+        sp /= worldSize ;
+
+        // The color comes out of the perlin noise mapping from the 3-space position,
+        // so it varies smoothly in 3 space.
+        //float n = Perlin::pnoise( sinf(sp.x), cosf(2*sp.y), sp.z, tw.x, 2,2,2,2 ) ;
+        //float n = Perlin::pnoise( sinf(2*M_PI*sp.x), cosf(2*M_PI*sp.y), sp.z, tw.x, 2,2,1,8 ) ;
+        float n = Perlin::pnoise( sp.x, sp.y, sp.z, wTexture, 1,1,1,wTexturePeriod ) ;
+
+        Vector3f color = Vector3f::cubicSpline( n, Vector3f( 0.45,0.34,0.54 ),
+          Vector3f( 0.87,0.1,0 ),
+          Vector3f( 0.66,0.24,0.2 ),
+          Vector3f( 0.55,0.21,0.1 )
+        ) ;
+
+        // Negative color is undefined
+        color.fabs() ;
+
+        // No extreme colors
+        //color.clampLen( 0.45f, 0.65f ) ;
+
+        // Give each vertex this uniqueish smooth color
+        verts[i].color.xyz() = color ;
+      } ) ;
+    }
+
+    if( attribs & AttribTexCoord )
+    {
+      // this makes the texture repeat (textureRepeats) times across the world
+      Vector2f texScale = Vector2f(textureRepeats) / worldSize.xy() ;
+      parallelFor( numVerts, [&]( int i ) {
+        verts[i].tex = verts[i].pos.xy() * texScale ;
+      } ) ;
+    }
+  }
+  
+  
+} ;
+
+
 #endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include "Mesh.h"
+
+// Reorders an indexed Mesh for the GPU, without changing what it looks like:
+//   1. triangles, for post-transform vertex cache reuse (Forsyth's linear-speed algorithm),
+//   2. runs of those triangles, so the outward facing ones tend to draw first (less overdraw),
+//   3. vertices, into the order the triangles first use them (fetch locality).
+// Run it last, after smoothMesh/decimation, so the exports get the optimized order too.
+
+// How well a triangle order uses a FIFO post-transform cache of cacheSize verts:
+// ACMR (average cache miss ratio) is vertex transforms per triangle (0.5 is ideal on a big mesh, 3 is worst),
+// ATVR (average transform to vertex ratio) is vertex transforms per vertex used (1 is ideal).
+struct VertexCacheStats
+{
+  float acmr, atvr ;
+} ;
+
+inline VertexCacheStats vertexCacheStats( const vector<int>& indices, int numVerts, int cacheSize=16 )
+{
+  vector<int> cachedAt( numVerts, -cacheSize-1 ) ; // the transform count when each vertex went in the cache
+  vector<char> used( numVerts, 0 ) ;
+  int transforms = 0, numUsed = 0 ;
+  for( int i = 0 ; i < indices.size() ; i++ )
+  {
+    int v = indices[i] ;
+    // FIFO: a vertex stays in for the next cacheSize misses, hits don't refresh it
+    if( transforms - cachedAt[v] > cacheSize )
+      cachedAt[v] = transforms++ ;
+    if( !used[v] )
+    {
+      used[v] = 1 ;
+      numUsed++ ;
+    }
+  }
+  VertexCacheStats stats ;
+  stats.acmr = indices.size() ? (float)transforms / ( indices.size()/3 ) : 0.f ;
+  stats.atvr = numUsed ? (float)transforms / numUsed : 0.f ;
+  return stats ;
+}
+
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006).
+// Greedily emits the triangle with the best score, where a vertex scores higher the more
+// recently it was used (it's in the simulated LRU cache) and the fewer triangles it has left
+// (so vertices get finished off rather than left dangling).
+struct ForsythOptimizer
+{
+  static const int CacheSize = 32 ;
+
+  static float vertexScore( int cachePos, int trisLeft )
+  {
+    if( trisLeft == 0 )  return -1.f ; // nothing left to draw with it
+    float score = 0.f ;
+    if( cachePos >= 0 )
+    {
+      if( cachePos < 3 )
+        score = 0.75f ; // used by the last triangle: fixed score so it isn't reused straight away
+      else
+        score = powf( 1.f - (float)( cachePos - 3 )/( CacheSize - 3 ), 1.5f ) ;
+    }
+    return score + 2.f/sqrtf( (float)trisLeft ) ;
+  }
+
+  // Reorders the triangles of indices in place (vertexTriangles are its triangles per vertex).
+  // The working arrays are the mesh's scratch, so they keep their capacity from 1 regen to the next.
+  static void optimize( vector<int>& indices, const VertexTriangles& vertexTriangles, MeshScratch& scratch )
+  {
+    int numTris = (int)indices.size()/3 ;
+    if( !numTris )  return ;
+
+    // each vertex's triangles not drawn yet are the first trisLeft[v] of its row
+    // (in a copy of the rows: drawn ones get swapped out past the end)
+    int numVerts = vertexTriangles.numVerts() ;
+    const vector<int>& trisStart = vertexTriangles.start ;
+    vector<int>& vertTris = scratch.vertTris ;
+    vector<int>& trisLeft = scratch.trisLeft ;
+    vector<int>& cachePos = scratch.cachePos ;
+    vertTris = vertexTriangles.tris ;
+    trisLeft.resize( numVerts ) ;
+    for( int v = 0 ; v < numVerts ; v++ )
+      trisLeft[v] = trisStart[v+1] - trisStart[v] ;
+
+    cachePos.assign( numVerts, -1 ) ;
+    vector<float>& vScore = scratch.vScore ;
+    vector<float>& tScore = scratch.tScore ;
+    vScore.resize( numVerts ) ;
+    for( int v = 0 ; v < numVerts ; v++ )
+      vScore[v] = vertexScore( -1, trisLeft[v] ) ;
+    tScore.resize( numTris ) ;
+    for( int t = 0 ; t < numTris ; t++ )
+      tScore[t] = vScore[ indices[3*t] ] + vScore[ indices[3*t+1] ] + vScore[ indices[3*t+2] ] ;
+
+    vector<char>& emitted = scratch.emitted ;
+    emitted.assign( numTris, 0 ) ;
+    vector<int>& out = scratch.indices ; // swapped with indices, so the 2 buffers take turns
+    out.clear() ;
+    out.reserve( 3*numTris ) ;
+    int cache[CacheSize+3], cacheCount = 0 ;
+    int nextUnemitted = 0 ; // for when nothing in the cache has a triangle left
+
+    int best = 0 ;
+    float bestScore = tScore[0] ;
+    for( int t = 1 ; t < numTris ; t++ )
+      if( tScore[t] > bestScore )
+        best = t, bestScore = tScore[t] ;
+
+    for( int emittedCount = 0 ; emittedCount < numTris ; emittedCount++ )
+    {
+      if( best < 0 )
+      {
+        // cache is out of triangles: start again at the first one not drawn yet
+        while( emitted[nextUnemitted] )  nextUnemitted++ ;
+        best = nextUnemitted ;
+      }
+
+      int* tri = &indices[3*best] ;
+      emitted[best] = 1 ;
+      out.insert( out.end(), tri, tri+3 ) ;
+
+      // the triangle's verts go to the front of the LRU cache, the rest shuffle back
+      int newCache[CacheSize+3], newCount = 0 ;
+      for( int c = 0 ; c < 3 ; c++ )
+      {
+        int v = tri[c] ;
+        newCache[newCount++] = v ;
+        int* ts = &vertTris[ trisStart[v] ] ;
+        // take best out of v's list of triangles left
+        for( int k = 0 ; k < trisLeft[v] ; k++ )
+          if( ts[k] == best )
+          {
+            ts[k] = ts[ trisLeft[v]-1 ] ;
+            trisLeft[v]-- ;
+            break ;
+          }
+      }
+      for( int c = 0 ; c < cacheCount ; c++ )
+      {
+        int v = cache[c] ;
+        if( v != tri[0] && v != tri[1] && v != tri[2] )
+          newCache[newCount++] = v ;
+      }
+
+      // rescore the verts in (and just pushed out of) the cache, and their triangles
+      for( int c = 0 ; c < newCount ; c++ )
+      {
+        int v = newCache[c] ;
+        cachePos[v] = c < CacheSize ? c : -1 ;
+        vScore[v] = vertexScore( cachePos[v], trisLeft[v] ) ;
+      }
+      best = -1, bestScore = -1.f ;
+      for( int c = 0 ; c < newCount ; c++ )
+      {
+        int v = newCache[c] ;
+        int* ts = &vertTris[ trisStart[v] ] ;
+        for( int k = 0 ; k < trisLeft[v] ; k++ )
+        {
+          int t = ts[k] ;
+          int* ti = &indices[3*t] ;
+          tScore[t] = vScore[ ti[0] ] + vScore[ ti[1] ] + vScore[ ti[2] ] ;
+          if( tScore[t] > bestScore )
+            best = t, bestScore = tScore[t] ;
+        }
+      }
+
+      cacheCount = min( newCount, (int)CacheSize ) ;
+      for( int c = 0 ; c < cacheCount ; c++ )
+        cache[c] = newCache[c] ;
+    }
+
+    indices.swap( out ) ;
+  }
+} ;
+
+// Overdraw, after Sander, Nehab & Barczak, "Fast Triangle Reordering for Vertex Locality
+// and Reduced Overdraw" (2007): cut the cache-optimized order into clusters where the
+// cache starts over anyway (a triangle that misses on all 3 verts), then draw the clusters
+// that face out from the middle of the mesh first, since they tend to hide the others.
+// Moving whole clusters around costs nearly nothing in cache misses.
+// (The mesh's scratch again, like ForsythOptimizer::optimize.)
+inline void optimizeOverdraw( vector<int>& indices, const vector<VertexPNCT>& verts, MeshScratch& scratch, int cacheSize=16 )
+{
+  int numTris = (int)indices.size()/3 ;
+  if( !numTris )  return ;
+
+  // cluster starts
+  vector<int>& clusterStart = scratch.clusterStart ;
+  vector<int>& cachedAt = scratch.cachedAt ;
+  clusterStart.clear() ;
+  cachedAt.assign( verts.size(), -cacheSize-1 ) ;
+  int transforms = 0 ;
+  for( int t = 0 ; t < numTris ; t++ )
+  {
+    int misses = 0 ;
+    for( int c = 0 ; c < 3 ; c++ )
+    {
+      int v = indices[3*t+c] ;
+      if( transforms - cachedAt[v] > cacheSize )
+      {
+        cachedAt[v] = transforms++ ;
+        misses++ ;
+      }
+    }
+    if( misses == 3 || t == 0 )
+      clusterStart.push_back( t ) ;
+  }
+  clusterStart.push_back( numTris ) ;
+  int numClusters = (int)clusterStart.size() - 1 ;
+
+  Vector3f meshCenter ;
+  for( int v = 0 ; v < verts.size() ; v++ )
+    meshCenter += verts[v].pos ;
+  meshCenter /= max( (int)verts.size(), 1 ) ;
+
+  // how much each cluster faces away from the middle: (its center - mesh center) . its normal
+  vector<float>& facing = scratch.facing ;
+  facing.resize( numClusters ) ;
+  parallelFor( numClusters, [&]( int k ) {
+    Vector3f center, normal ;
+    float area = 0.f ;
+    for( int t = clusterStart[k] ; t < clusterStart[k+1] ; t++ )
+    {
+      const Vector3f& a = verts[ indices[3*t] ].pos ;
+      const Vector3f& b = verts[ indices[3*t+1] ].pos ;
+      const Vector3f& c = verts[ indices[3*t+2] ].pos ;
+      // Triangle::triNormal's winding
+      Vector3f n = ( a-b ).cross( c-b ) ;
+      float triArea = n.len() ;
+      center += ( a+b+c )*( triArea/3 ) ;
+      normal += n ;
+      area += triArea ;
+    }
+    if( area > 0 )  center /= area ;
+    facing[k] = ( center - meshCenter ).dot( normal ) ;
+  } ) ;
+
+  // (a-b)x(c-b) is the way the mesh is shaded (the vertex normals agree with it), and it points
+  // out of the surface, so the clusters that face out the most are the most positive, and go first
+  // (ties go in cluster order, like a stable_sort, which would want a temporary buffer)
+  vector<int>& order = scratch.order ;
+  order.resize( numClusters ) ;
+  for( int k = 0 ; k < numClusters ; k++ )
+    order[k] = k ;
+  sort( order.begin(), order.end(), [&]( int a, int b ) {
+    return facing[a] > facing[b] || ( facing[a] == facing[b] && a < b ) ;
+  } ) ;
+
+  vector<int>& out = scratch.indices ;
+  out.clear() ;
+  out.reserve( indices.size() ) ;
+  for( int k : order )
+    out.insert( out.end(), indices.begin() + 3*clusterStart[k], indices.begin() + 3*clusterStart[k+1] ) ;
+  indices.swap( out ) ;
+}
+
+// All 3 steps on mesh (an indexed triangle mesh).
+inline void optimizeMesh( Mesh& mesh )
+{
+  ForsythOptimizer::optimize( mesh.indices, mesh.vertexTriangles(), mesh.scratch ) ;
+  mesh.indicesChanged() ;
+  optimizeOverdraw( mesh.indices, mesh.verts, mesh.scratch ) ;
+  mesh.indicesChanged() ;
+  // rebuild() numbers the verts in the order the triangles first use them
+  mesh.rebuild() ;
+}
+
+#endif
@@ -0,0 +1,206 @@
+#ifndef PACKEDMESH_H
+#define PACKEDMESH_H
+
+#include "Mesh.h"
+
+// A 20 byte vertex (VertexPNCT is 48), in types fixed function GL reads straight out of a client array:
+//   pos    xyz as shorts across the bounds the mesh was packed in (w is always 1),
+//   normal snorm8 (GL maps GL_BYTE normals to [-1,1] itself),
+//   color  RGBA8,
+//   tex    shorts, in units of PackedMesh::texScale.
+// The 4th normal byte only pads the color out to a 4 byte boundary.
+struct VertexPacked
+{
+  short pos[4] ;
+  signed char normal[4] ;
+  unsigned char color[4] ;
+  short tex[2] ;
+} ;
+
+// The indexed triangles of a Mesh with VertexPacked verts.
+// Positions dequantize as center + pos*posScale, texcoords as tex*texScale,
+// which draw() does with the modelview and texture matrices, so nothing gets unpacked on the CPU.
+// The scale is the same on every axis, so the normals only need GL_NORMALIZE to stay right.
+struct PackedMesh
+{
+  vector<VertexPacked> verts ;
+  vector<int> indices ;
+  int numIndices ;  // the ones drawn and exported, the first numIndices of indices
+  Vector3f center ;
+  float posScale, texScale ;
+
+  PackedMesh() : numIndices(0), posScale(1.f), texScale(1.f)
+  {
+  }
+
+  static inline int roundInt( float x )
+  {
+    return (int)floorf( x + 0.5f ) ;
+  }
+
+  static inline short quantizeShort( float x )
+  {
+    return (short)roundInt( clamp( x, -32767.f, 32767.f ) ) ;
+  }
+
+  // Packs the first numIndices of indices (triangles) and verts, whose positions are all within
+  // boundsMin..boundsMax.  Every index is copied, but only those numIndices are drawn and exported,
+  // so a level of a ProgressiveMesh (a prefix of its indices) packs, and stays packed, as it is.
+  // Pack into the voxel grid's bounds, so the grid's walls land exactly on +/-32767
+  // and the seams of a periodic world still line up after quantization.
+  void pack( const vector<VertexPNCT>& meshVerts, const vector<int>& meshIndices, int numIndices,
+    const Vector3f& boundsMin, const Vector3f& boundsMax )
+  {
+    center = ( boundsMin + boundsMax )/2 ;
+    Vector3f half = ( boundsMax - boundsMin )/2 ;
+    float halfExtent = max( half.x, max( half.y, half.z ) ) ;
+    posScale = halfExtent > 0 ? halfExtent/32767 : 1.f ;
+
+    float maxTex = 0.f ;
+    for( int i = 0 ; i < meshVerts.size() ; i++ )
+      maxTex = max( maxTex, max( fabsf( meshVerts[i].tex.x ), fabsf( meshVerts[i].tex.y ) ) ) ;
+    texScale = maxTex > 0 ? maxTex/32767 : 1.f ;
+
+    verts.resize( meshVerts.size() ) ;
+    parallelFor( (int)verts.size(), [&]( int i ) {
+      packVertex( i, meshVerts[i] ) ;
+    } ) ;
+
+    indices = meshIndices ;
+    this->numIndices = numIndices ;
+  }
+
+  void pack( const Mesh& mesh, const Vector3f& boundsMin, const Vector3f& boundsMax )
+  {
+    pack( mesh.verts, mesh.indices, (int)mesh.indices.size(), boundsMin, boundsMax ) ;
+  }
+
+  // Packs v into verts[i] with the current scales (so v's texcoords have to be within the ones
+  // it was packed with, like a ProgressiveMesh vertex that only moves).
+  void packVertex( int i, const VertexPNCT& v )
+  {
+    float invPosScale = 1.f/posScale, invTexScale = 1.f/texScale ;
+    VertexPacked& o = verts[i] ;
+    for( int c = 0 ; c < 3 ; c++ )
+    {
+      o.pos[c] = quantizeShort( ( v.pos.elts[c] - center.elts[c] )*invPosScale ) ;
+      o.normal[c] = (signed char)roundInt( clamp_11( v.normal.elts[c] )*127 ) ;
+    }
+    o.pos[3] = 1 ;
+    o.normal[3] = 0 ;
+    for( int c = 0 ; c < 4 ; c++ )
+      o.color[c] = (unsigned char)roundInt( clamp_01( v.color.elts[c] )*255 ) ;
+    o.tex[0] = quantizeShort( v.tex.x*invTexScale ) ;
+    o.tex[1] = quantizeShort( v.tex.y*invTexScale ) ;
+  }
+
+  Vector3f getPos( int i ) const
+  {
+    const short* q = verts[i].pos ;
+    return center + Vector3f( q[0], q[1], q[2] )*posScale ;
+  }
+
+  Vector3f getNormal( int i ) const
+  {
+    const signed char* q = verts[i].normal ;
+    return Vector3f( q[0], q[1], q[2] )/127 ;
+  }
+
+  // Draws with GL's client arrays straight from verts.
+  // transform is called between pushing the modelview and applying the dequantization,
+  // so whatever it translates by (the repeats) stays in world units.
+  template <typename F>
+  void draw( const F& transform ) const
+  {
+    if( verts.empty() || !numIndices )  return ;
+
+    glVertexPointer( 4, GL_SHORT, sizeof( VertexPacked ), verts[0].pos ) ;
+    glNormalPointer( GL_BYTE, sizeof( VertexPacked ), verts[0].normal ) ;
+    glColorPointer( 4, GL_UNSIGNED_BYTE, sizeof( VertexPacked ), verts[0].color ) ;
+    glTexCoordPointer( 2, GL_SHORT, sizeof( VertexPacked ), verts[0].tex ) ;
+
+    glMatrixMode( GL_TEXTURE ) ;
+    glPushMatrix() ;
+    glLoadIdentity() ;
+    glScalef( texScale, texScale, 1 ) ;
+    glMatrixMode( GL_MODELVIEW ) ;
+    glEnable( GL_NORMALIZE ) ;
+
+    glPushMatrix() ;
+    transform() ;
+    glTranslatef( center.x, center.y, center.z ) ;
+    glScalef( posScale, posScale, posScale ) ;
+    glDrawElements( GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, &indices[0] ) ;
+    glPopMatrix() ;
+
+    glDisable( GL_NORMALIZE ) ;
+    glMatrixMode( GL_TEXTURE ) ;
+    glPopMatrix() ;
+    glMatrixMode( GL_MODELVIEW ) ;
+  }
+
+  // Binary .ply of the packed verts as they are (17 bytes a vertex, 13 a face),
+  // with the dequantization in the header's comments.
+  bool exportPLY( const char* filename ) const
+  {
+    FILE* f = fopen( filename, "wb" ) ;
+    if( !f )
+    {
+      printf( "Can't open '%s'\n", filename ) ;
+      return false ;
+    }
+
+    // shorts and ints go out in this machine's byte order, so say which one that is
+    unsigned int one = 1 ;
+    bool littleEndian = *(unsigned char*)&one ;
+    fprintf( f, "ply\nformat %s 1.0\n", littleEndian ? "binary_little_endian" : "binary_big_endian" ) ;
+    fprintf( f, "comment position = (%f %f %f) + xyz*%g\n", center.x, center.y, center.z, posScale ) ;
+    fprintf( f, "comment normal = n/127, color = rgba/255, texcoord = st*%g\n", texScale ) ;
+    fprintf( f, "element vertex %d\n", (int)verts.size() ) ;
+    fprintf( f, "property short x\nproperty short y\nproperty short z\n" ) ;
+    fprintf( f, "property char nx\nproperty char ny\nproperty char nz\n" ) ;
+    fprintf( f, "property uchar red\nproperty uchar green\nproperty uchar blue\nproperty uchar alpha\n" ) ;
+    fprintf( f, "property short s\nproperty short t\n" ) ;
+    fprintf( f, "element face %d\n", numIndices/3 ) ;
+    fprintf( f, "property list uchar int vertex_indices\nend_header\n" ) ;
+
+    const int chunkBytes = 1<<18 ;
+    vector<unsigned char> chunk ;
+    chunk.reserve( chunkBytes + 32 ) ;
+    auto put = [&]( const void* data, int bytes ) {
+      const unsigned char* b = (const unsigned char*)data ;
+      chunk.insert( chunk.end(), b, b+bytes ) ;
+    } ;
+    auto flush = [&]( bool force ) {
+      if( chunk.size() && ( force || chunk.size() >= chunkBytes ) )
+      {
+        fwrite( &chunk[0], 1, chunk.size(), f ) ;
+        chunk.clear() ;
+      }
+    } ;
+
+    for( int i = 0 ; i < verts.size() ; i++ )
+    {
+      put( verts[i].pos, 3*sizeof(short) ) ;
+      put( verts[i].normal, 3 ) ;
+      put( verts[i].color, 4 ) ;
+      put( verts[i].tex, 2*sizeof(short) ) ;
+      flush( false ) ;
+    }
+    unsigned char three = 3 ;
+    for( int i = 0 ; i+2 < numIndices ; i += 3 )
+    {
+      put( &three, 1 ) ;
+      put( &indices[i], 3*sizeof(int) ) ;
+      flush( false ) ;
+    }
+    flush( true ) ;
+
+    fclose( f ) ;
+    printf( "Wrote %d verts, %d tris (%d bytes a vertex) to '%s'\n",
+      (int)verts.size(), numIndices/3, (int)sizeof( VertexPacked ), filename ) ;
+    return true ;
+  }
+} ;
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "StdWilUtil.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// How many threads to split a parallel loop over (at least 1).
+inline int numWorkerThreads()
+{
+  int n = (int)thread::hardware_concurrency() ;
+  return n > 0 ? n : 1 ;
+}
+
+// The threads parallelForChunks runs its chunks on.  They're started the first time a loop
+// needs them and then sleep between loops, so a parallel loop doesn't create threads
+// (or allocate anything for them) each time it runs.
+class WorkerPool
+{
+  vector<thread> workers ; // worker w-1 runs chunk w
+  mutex m ;
+  condition_variable wake, done ;
+  void (*runChunk)( const void* job, int t ) ;
+  const void* job ;
+  int jobThreads ;  // chunks in the current job (the caller runs chunk 0)
+  int pending ;     // workers still running a chunk of it
+  unsigned int generation ; // goes up 1 per job
+  bool busy, quit ;
+
+  WorkerPool() : runChunk(0), job(0), jobThreads(0), pending(0), generation(0), busy(0), quit(0)
+  {
+  }
+
+  ~WorkerPool()
+  {
+    {
+      lock_guard<mutex> lock( m ) ;
+      quit = 1 ;
+    }
+    wake.notify_all() ;
+    for( int w = 0 ; w < workers.size() ; w++ )
+      workers[w].join() ;
+  }
+
+  void workerLoop( int t, unsigned int seen )
+  {
+    unique_lock<mutex> lock( m ) ;
+    for( ;; )
+    {
+      wake.wait( lock, [&]{ return quit || generation != seen ; } ) ;
+      if( quit )  return ;
+      seen = generation ;
+      if( t >= jobThreads )  skip ; // a job with fewer chunks than there are workers
+      lock.unlock() ;
+      runChunk( job, t ) ;
+      lock.lock() ;
+      if( --pending == 0 )
+        done.notify_one() ;
+    }
+  }
+
+public:
+  static WorkerPool& get()
+  {
+    static WorkerPool pool ;
+    return pool ;
+  }
+
+  // Runs runChunk( iJob, t ) for t in [0,numThreads), chunk 0 on the calling thread.
+  // Returns false without running anything if the pool is already running a job
+  // (a parallel loop inside a parallel loop), so the caller can run the chunks itself.
+  bool run( int numThreads, const void* iJob, void (*iRunChunk)( const void*, int ) )
+  {
+    {
+      lock_guard<mutex> lock( m ) ;
+      if( busy )  return false ;
+      busy = 1 ;
+      while( workers.size() < numThreads-1 )
+        workers.push_back( thread( &WorkerPool::workerLoop, this, (int)workers.size()+1, generation ) ) ;
+      job = iJob ;
+      runChunk = iRunChunk ;
+      jobThreads = numThreads ;
+      pending = numThreads-1 ;
+      generation++ ;
+    }
+    wake.notify_all() ;
+
+    iRunChunk( iJob, 0 ) ;
+
+    unique_lock<mutex> lock( m ) ;
+    done.wait( lock, [&]{ return pending == 0 ; } ) ;
+    busy = 0 ;
+    return true ;
+  }
+} ;
+
+template <typename F>
+void callChunk( const void* f, int t )
+{
+  ( *(const F*)f )( t ) ;
+}
+
+// Splits [0,n) into numThreads contiguous chunks, in order, and runs
+// body( threadIndex, begin, end ) on each chunk on its own thread (from the WorkerPool).
+// Thread t always gets the t'th chunk, so per-thread results can be
+// joined back together in order afterwards.
+// Chunk 0 runs on the calling thread.  Returns when all chunks are done.
+// (Nested in another parallel loop, the chunks all run on the calling thread, in order.)
+template <typename Body>
+void parallelForChunks( int n, int numThreads, const Body& body )
+{
+  if( numThreads > n )  numThreads = n ;
+  if( numThreads <= 1 )
+  {
+    if( n > 0 )  body( 0, 0, n ) ;
+    return ;
+  }
+
+  auto chunk = [&body,n,numThreads]( int t ) {
+    body( t, (int)( (long long)n*t/numThreads ), (int)( (long long)n*(t+1)/numThreads ) ) ;
+  } ;
+  if( !WorkerPool::get().run( numThreads, &chunk, &callChunk<decltype( chunk )> ) )
+    for( int t = 0 ; t < numThreads ; t++ )
+      chunk( t ) ;
+}
+
+// Runs body( i ) for every i in [0,n), spread over all the worker threads.
+template <typename Body>
+void parallelFor( int n, const Body& body )
+{
+  parallelForChunks( n, numWorkerThreads(), [&body]( int, int begin, int end ) {
+    for( int i = begin ; i < end ; i++ )
+      body( i ) ;
+  } ) ;
+}
+
+// A growable array of atomic ints, for the count / prefix sum / scatter passes that
+// run over threads.  It's scratch: it only grows (atomics can't be moved, so it can't
+// resize in place), and copying the thing that holds it copies none of it.
+struct AtomicCounts
+{
+  vector< atomic<int> > counts ;
+
+  AtomicCounts() {}
+  AtomicCounts( const AtomicCounts& ) {}
+  AtomicCounts& operator=( const AtomicCounts& ) { return *this ; }
+
+  // room for n counts (what they start at is up to the caller)
+  void reserve( int n )
+  {
+    if( counts.size() < n )
+      vector< atomic<int> >( n ).swap( counts ) ;
+  }
+  void release() { vector< atomic<int> >().swap( counts ) ; }
+  inline atomic<int>& operator[]( int i ) { return counts[i] ; }
+} ;
+
+#endif
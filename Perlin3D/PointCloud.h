@@ -1,206 +1,457 @@
-#ifndef POINTCLOUD_H
-#define POINTCLOUD_H
-
-#include "Vectorf.h"
-#include "MarchingCommon.h"
-
-struct PointCloud : public IsosurfaceFinder
-{
-  // Point cloud vars.
-  static float ptSize, cubeSize ;
-  static bool useCubes ;  // point clouds use cubes?
-
-  // structures and code for creating the point cloud
-  // with points at isosurface breakthroughs etc.
-  #pragma region structs
-  // This code is generally not to be used unless you want to start
-  // from a point where you JUST KNOW the isosurface punchthru points,
-  // but nothing about how the surface is connected.
-
-  // It may be a nice starting point for generating a tetrahedralization based on
-  // a point cloud.
-  struct IsosurfacePunchthru
-  {
-    // the original voxel index that DETECTED the punchthru
-    Vector3i voxelIndex ;
-
-    // The actual 3-space point of the punchthru
-    // this is computed based on dv and the values at
-    // the actual voxels where this punchthru took place.
-    //Vector3f pt ;
-    int directionIndex ; // the direction of the vector that breaks the isosurface.
-    // looks up into IsosurfacePunchthruSet.Directions[ directionIndex ] to get the actual direction.
-  
-    float t ;    // how far between voxelIndex and the voxel at directionIndex you were at isosurface intn.
-    float dv ;   // the actual jump in value across dir.
-
-    IsosurfacePunchthru():t(0.f),dv(0.f)
-    {
-    }
-
-    IsosurfacePunchthru( Vector3i iVoxelIndex, int iDirectionIndex, float iT, float iDv ) :
-      voxelIndex(iVoxelIndex),directionIndex(iDirectionIndex),t(iT),dv(iDv)
-    {
-    }
-  } ;
-
-  // Every POINT stores the directions for which the isosurface
-  // punchthru succeeded.  So you store up to (Directions.size())
-  // POINTERS inside an IsosurfacePunchthruSet.
-  struct IsosurfacePunchthruSet
-  {
-    // There are 26 directions over which the isosurface can break.
-    // (1 towards each of the 26 points that surround each 3x3 group).
-    // If isosurface is drawn differently for going - and going + into it,
-    // it will be 2 sided and have different colors.  Or you can just draw
-    // the + side, or you can even give it a thickness (provided grid spacing
-    // is course enough.)
-
-    // indexing is a 3x3x3 cube LINEAR indexing 
-    // in the order z,y,x.
-    vector<IsosurfacePunchthru*> directedPunchthrus ; // punchthrus indexed by directions in Directions.
-
-    IsosurfacePunchthruSet( int numDirs )
-    {
-      directedPunchthrus.resize( numDirs, 0 ) ;
-    }
-    ~IsosurfacePunchthruSet()
-    {
-      for( int i = 0 ; i < directedPunchthrus.size() ; i++ )
-        if( directedPunchthrus[i] )
-          delete directedPunchthrus[i] ;
-    }
-  } ;
-  #pragma endregion
-
-  // 1 isosurface punchthruset PER voxel
-  vector<IsosurfacePunchthruSet> punchthru ;
-  
-  // The set of Directions for which isosurface punchthrus are determined
-  // This is 
-  vector<Vector3i> Directions ;
-
-  // every DIRECTION has 1 or more NEIGHBOURS.
-  // So, this maps a 
-  vector< vector<int> > DirsNeighbours ;
-  // Directions[i] has neighbours listed by DirsNeighbours[i][0]..DirsNeighbours[i][size]
-
-  PointCloud( VoxelGrid *iVoxelGrid, vector<VertexPNCT>* iVerts, float iIsosurface, const Vector4f& color ) :
-    IsosurfaceFinder( iVoxelGrid, iVerts, iIsosurface, color )
-  {
-    initDirections() ;
-  }
-
-  // outputs a "point" into the global array data. used by pointcloud visualization.
-  void pt( const Vector3f& p, float size, const Vector4f& color )
-  {
-    if( useCubes )
-      Geometry::addCubeFacingOut( *verts, p, size*cubeSize, color ) ;
-    else
-      verts->push_back( VertexPNCT( p, Vector3f(0,1,0), color ) ) ;
-  }
-
-  void genVizPunchthru()
-  {
-    punchthru.clear() ;
-    punchthru.resize( voxelGrid->voxels.size(), IsosurfacePunchthruSet( (int)Directions.size() ) ) ;
-
-    for( int k = 0 ; k < voxelGrid->dims.z ; k++ )
-    {
-      for( int j = 0 ; j < voxelGrid->dims.y ; j++ )
-      {
-        for( int i = 0 ; i < voxelGrid->dims.x ; i++ )
-        {
-          Vector3i dex( i,j,k ) ;
-          int idex = voxelGrid->index( dex ) ;
-          float val = voxelGrid->voxels[ idex ].v ;
-        
-          // Measure the isosurface breaks in 26 directions.
-          //punchthru[dex.index(cols,rows)]. ;
-          for( int dirIndex = 0 ; dirIndex < Directions.size() ; dirIndex++ )
-          {
-            const Vector3i& dir = Directions[dirIndex] ; // GET A DIRECTION. ONE DIRECTION.
-            Vector3i adjCell = dex + dir ;    // GET THE IJK INDEX OF THE ADJACENT CELL IN THIS DIRECTION
-            voxelGrid->wrappedIndex( adjCell ) ;
-            float adjVal = (*voxelGrid)( adjCell ).v ; // MAKE SURE IS IN BOUNDS. WRAP AT BORDERS
-
-            float t = unlerp( isosurface, val, adjVal ) ;
-            if( isBetween( t, 0.f, 1.f ) )
-            {
-              // BROKE THE SURFACE
-              float diff = adjVal - val ; //+ if value INCREASES towards adjVal.
-              // this is the amount you need to "add" to val to GET adjVal.
-              //- if value GOING DOWN
-              // like a type of derivative
-              punchthru[idex].directedPunchthrus[dirIndex] = new IsosurfacePunchthru( dex, dirIndex, t, diff ) ;
-            
-              Vector3f voxelCenter = (voxelGrid->offset + dex)*voxelGrid->gridSizer ;
-              Vector3f p2 = (voxelGrid->offset + dex + dir)*voxelGrid->gridSizer ;
-              Vector3f p = Vector3f::lerp( t, voxelCenter, p2 ) ;
-              pt( p, 0.25, baseColor ) ;
-            }
-          }
-        }
-      }
-    }
-  }
-
-  void addDirection( const Vector3i& v )
-  {
-    Directions.push_back( v ) ;
-    DirsNeighbours.push_back( vector<int>() ) ;
-  }
-
-  void addNeighbours( int forDirection, int* neighbours, int len )
-  {
-    if( forDirection >= DirsNeighbours.size() )
-    {
-      printf( "%d oob DirsNeighbours (%d)\n", forDirection, (int)DirsNeighbours.size() ) ;
-      return ;
-    }
-    for( int i = 0 ; i < len ; i++ )
-      DirsNeighbours[forDirection].push_back( neighbours[i] ) ;
-  }
-
-  void initDirections()
-  {
-    addDirection( Vector3i( 1, 0, 0 ) ) ;  //0
-    addDirection( Vector3i( 0, 1, 0 ) ) ;  //1
-    addDirection( Vector3i( 0, 0, 1 ) ) ;  //2
-  
-    addDirection( Vector3i( -1,  0,  0 ) ) ; //3
-    addDirection( Vector3i(  0, -1,  0 ) ) ; //4
-    addDirection( Vector3i(  0,  0, -1 ) ) ; //5
-
-    // UPPER NEIGHBOR, LEFT NEIGHBOUR,  LEFT NEIGHBOUR, LOWER NEIGHBOUR
-    int px[4] = { 1, 2,  2, 4 } ;
-    addNeighbours( 0, px, 4 ) ;
-  
-    // y has NO NEIGHBOURS listed.
-    int pz[4] = { 1, 3,  3, 4 } ;
-    addNeighbours( 2, pz, 4 ) ;
-
-    int nx[4] = { 1, 5,  5, 4 } ;
-    addNeighbours( 3, nx, 4 ) ;
-
-    int nz[4] = { 1, 0,  0, 4 } ;
-    addNeighbours( 5, nz, 4 ) ;
-
-    /*
-    for( int i = 0 ; i < Directions.size() ; i++ )
-    {
-      Vector3i p = Directions[i] + 1 ; // ADD ONE WHEN GETTING INDEX
-      printf( "(%d,%d,%d) index %d\n", p.x, p.y, p.z, p.index( 3, 3 ) ) ;
-    }
-    */
-  }
-
-  
-} ;
-
-
-// Point cloud vars.
-float PointCloud::ptSize=1.f, PointCloud::cubeSize=50.f ;
-bool PointCloud::useCubes=1 ;
-  
+#ifndef POINTCLOUD_H
+#define POINTCLOUD_H
+
+#include "Vectorf.h"
+#include "MarchingCommon.h"
+#include "Parallel.h"
+
+struct PointCloud : public IsosurfaceFinder
+{
+  // Point cloud vars.
+  static float ptSize, cubeSize ;
+  static bool useCubes ;  // point clouds use cubes?
+
+  // structures and code for creating the point cloud
+  // with points at isosurface breakthroughs etc.
+  #pragma region structs
+  // This code is generally not to be used unless you want to start
+  // from a point where you JUST KNOW the isosurface punchthru points,
+  // but nothing about how the surface is connected.
+
+  // It may be a nice starting point for generating a tetrahedralization based on
+  // a point cloud.
+  struct IsosurfacePunchthru
+  {
+    // The voxel that DETECTED the punchthru isn't stored: hits are kept
+    // grouped by voxel (see punchthruStart), so it's whichever voxel's range the hit is in.
+
+    // The actual 3-space point of the punchthru
+    // this is computed based on dv and the values at
+    // the actual voxels where this punchthru took place.
+    //Vector3f pt ;
+    int directionIndex ; // the direction of the vector that breaks the isosurface.
+    // looks up into Directions[ directionIndex ] to get the actual direction.
+  
+    float t ;    // how far between the voxel and the voxel at directionIndex you were at isosurface intn.
+    float dv ;   // the actual jump in value across dir.
+
+    IsosurfacePunchthru():directionIndex(0),t(0.f),dv(0.f)
+    {
+    }
+
+    IsosurfacePunchthru( int iDirectionIndex, float iT, float iDv ) :
+      directionIndex(iDirectionIndex),t(iT),dv(iDv)
+    {
+    }
+  } ;
+  #pragma endregion
+
+  // Every voxel stores the directions for which the isosurface punchthru succeeded,
+  // packed flat (compressed sparse rows): the hits of voxel idex are
+  // punchthrus[ punchthruStart[idex] ] .. punchthrus[ punchthruStart[idex+1]-1 ],
+  // in increasing directionIndex.  Voxels with no hits cost just their 1 offset.
+  // These are static so the storage is reused by the next regen (a PointCloud is made per regen)
+  // instead of being allocated again.
+  static vector<int> punchthruStart ; // voxels.size()+1 offsets into punchthrus
+  static vector<IsosurfacePunchthru> punchthrus ;
+
+  int numPunchthrus( int idex ) const {
+    return punchthruStart[idex+1] - punchthruStart[idex] ;
+  }
+
+  const IsosurfacePunchthru* getPunchthrus( int idex ) const {
+    return punchthrus.data() + punchthruStart[idex] ;
+  }
+
+  // Gets the punchthru from voxel in direction dirIndex, if the surface is crossed there.
+  // Each crossing is only stored once, from the voxel on the scanDirs side, so asking
+  // from the other side looks up the neighbour's hit and turns it around.
+  bool getPunchthru( const Vector3i& voxel, int dirIndex, IsosurfacePunchthru& hit ) const
+  {
+    Vector3i from = voxel ;
+    int storedDir = dirIndex ;
+    bool flip = !isScanDir[ dirIndex ] ;
+    if( flip )
+    {
+      from += Directions[ dirIndex ] ;
+      storedDir = opposite[ dirIndex ] ;
+    }
+    int idex = voxelGrid->index( voxelGrid->wrappedIndex( from ) ) ;
+    for( int h = punchthruStart[idex] ; h < punchthruStart[idex+1] ; h++ )
+    {
+      if( punchthrus[h].directionIndex == storedDir )
+      {
+        hit = punchthrus[h] ;
+        if( flip )
+          hit = IsosurfacePunchthru( dirIndex, 1.f - hit.t, -hit.dv ) ;
+        return 1 ;
+      }
+    }
+    return 0 ;
+  }
+
+  // The set of Directions for which isosurface punchthrus are determined
+  // This is 
+  vector<Vector3i> Directions ;
+
+  // every DIRECTION has 1 or more NEIGHBOURS.
+  // So, this maps a 
+  vector< vector<int> > DirsNeighbours ;
+  // Directions[i] has neighbours listed by DirsNeighbours[i][0]..DirsNeighbours[i][size]
+
+  // Directions[ opposite[d] ] == -Directions[d] (-1 if -Directions[d] isn't a direction)
+  vector<int> opposite ;
+
+  // The directions actually scanned: one from each opposite pair, in increasing order.
+  // A crossing between 2 neighbours is found from one of them only, so it's emitted once.
+  vector<int> scanDirs ;
+  vector<bool> isScanDir ;
+
+  // Per thread scratch for genVizPunchthru, kept between regens.
+  struct ScanBuffer
+  {
+    vector<IsosurfacePunchthru> hits ; // this thread's hits, in voxel index order
+    vector<VertexPNCT> verts ;         // this thread's points
+    vector<float> vals ;               // the row being scanned
+    vector<float> adjVals, t ;         // per scan direction, the neighbours' values along the row and the crossing t's
+    vector<unsigned int> hitDirs ;     // per voxel in the row, bit s set if scanDirs[s] crosses the surface
+  } ;
+  static vector<ScanBuffer> scanBuffers ;
+
+  // output the visualization points (cubes) as hits are found?
+  // exportPLY turns this off, it only needs the hits.
+  bool genPoints ;
+
+  PointCloud( VoxelGrid *iVoxelGrid, vector<VertexPNCT>* iVerts, float iIsosurface, const Vector4f& color ) :
+    IsosurfaceFinder( iVoxelGrid, iVerts, iIsosurface, color )
+  {
+    genPoints = true ;
+    initDirections() ;
+  }
+
+  // outputs a "point" into out. used by pointcloud visualization.
+  // It's always 1 vertex.  With useCubes on, it's the instance a cube gets drawn at
+  // (see drawPointCubes), so cubeSize can change without regenerating anything.
+  void pt( vector<VertexPNCT>& out, const Vector3f& p, const Vector4f& color )
+  {
+    out.push_back( VertexPNCT( p, Vector3f(0,1,0), color ) ) ;
+  }
+
+  void pt( const Vector3f& p, const Vector4f& color )
+  {
+    pt( *verts, p, color ) ;
+  }
+
+  // size of the cube drawn at each point
+  static float cubeSide() { return 0.25f*cubeSize ; }
+
+  // The 36 verts of the cube every point is drawn as, unit size, centered at the origin
+  static const vector<VertexPNCT>& unitCube()
+  {
+    static vector<VertexPNCT> cube ;
+    if( cube.empty() )
+      Geometry::addCubeFacingOut( cube, Vector3f(), 1.f, White ) ;
+    return cube ;
+  }
+
+  // Scans row j of slab k for crossings along scanDirs, into buf.
+  void scanRow( int j, int k, ScanBuffer& buf )
+  {
+    const Vector3i& dims = voxelGrid->dims ;
+    int numScanDirs = (int)scanDirs.size() ;
+    int rowStart = voxelGrid->index( 0, j, k ) ;
+
+    // Pull the row's values (and each neighbour row's) out of the voxels into flat arrays,
+    // so the unlerp/isBetween tests below are straight float loops the compiler can vectorize.
+    float *vals = &buf.vals[0] ;
+    unsigned int *hitDirs = &buf.hitDirs[0] ;
+    for( int i = 0 ; i < dims.x ; i++ )
+    {
+      vals[i] = voxelGrid->voxels[ rowStart+i ].v ;
+      hitDirs[i] = 0 ;
+    }
+
+    for( int s = 0 ; s < numScanDirs ; s++ )
+    {
+      // the neighbour row in this direction, shifted by dir.x (WRAP AT BORDERS)
+      const Vector3i& dir = Directions[ scanDirs[s] ] ;
+      Vector3i adjRow( dir.x, j+dir.y, k+dir.z ) ;
+      voxelGrid->wrappedIndex( adjRow ) ;
+      int adjStart = voxelGrid->index( 0, adjRow.y, adjRow.z ) ;
+
+      float *adjVals = &buf.adjVals[ s*dims.x ] ;
+      float *t = &buf.t[ s*dims.x ] ;
+      for( int i = 0 ; i < dims.x ; i++ )
+      {
+        int ai = i + adjRow.x ;
+        if( ai >= dims.x )  ai -= dims.x ;
+        adjVals[i] = voxelGrid->voxels[ adjStart+ai ].v ;
+      }
+      for( int i = 0 ; i < dims.x ; i++ )
+        t[i] = unlerp( isosurface, vals[i], adjVals[i] ) ;
+      for( int i = 0 ; i < dims.x ; i++ )
+        hitDirs[i] |= (unsigned int)isBetween( t[i], 0.f, 1.f ) << s ;
+    }
+
+    for( int i = 0 ; i < dims.x ; i++ )
+    {
+      if( !hitDirs[i] )  skip ;
+
+      // BROKE THE SURFACE
+      Vector3i dex( i,j,k ) ;
+      Vector3f voxelCenter = (voxelGrid->offset + dex)*voxelGrid->gridSizer ;
+      for( int s = 0 ; s < numScanDirs ; s++ )
+      {
+        if( !( hitDirs[i] & (1<<s) ) )  skip ;
+
+        float t = buf.t[ s*dims.x + i ] ;
+        // dv is + if value INCREASES towards adjVal.
+        // this is the amount you need to "add" to val to GET adjVal.
+        //- if value GOING DOWN
+        // like a type of derivative
+        float diff = buf.adjVals[ s*dims.x + i ] - vals[i] ;
+        buf.hits.push_back( IsosurfacePunchthru( scanDirs[s], t, diff ) ) ;
+
+        if( genPoints )
+        {
+          Vector3f p2 = (voxelGrid->offset + dex + Directions[ scanDirs[s] ])*voxelGrid->gridSizer ;
+          Vector3f p = Vector3f::lerp( t, voxelCenter, p2 ) ;
+          pt( buf.verts, p, baseColor ) ;
+        }
+      }
+      punchthruStart[ rowStart+i+1 ] = popCount( hitDirs[i] ) ;
+    }
+  }
+
+  static int popCount( unsigned int bits )
+  {
+    int n = 0 ;
+    for( ; bits ; bits &= bits-1 )  n++ ;
+    return n ;
+  }
+
+  void genVizPunchthru()
+  {
+    const Vector3i& dims = voxelGrid->dims ;
+    int numScanDirs = (int)scanDirs.size() ;
+
+    // punchthruStart[idex+1] gets voxel idex's hit count first, then is summed into offsets.
+    // assign()/clear() keep the capacity from last time, so regens don't reallocate.
+    punchthruStart.assign( voxelGrid->voxels.size()+1, 0 ) ;
+    punchthrus.clear() ;
+
+    // Each thread scans a run of whole slabs into its own buffer.  Thread t gets the t'th run,
+    // so concatenating the buffers in thread order gives the hits in voxel index order.
+    int numThreads = min( numWorkerThreads(), dims.z ) ;
+    if( scanBuffers.size() < numThreads )
+      scanBuffers.resize( numThreads ) ;
+    parallelForChunks( dims.z, numThreads, [&]( int threadIndex, int kBegin, int kEnd ) {
+      ScanBuffer& buf = scanBuffers[ threadIndex ] ;
+      buf.hits.clear() ;
+      buf.verts.clear() ;
+      buf.vals.resize( dims.x ) ;
+      buf.hitDirs.resize( dims.x ) ;
+      buf.adjVals.resize( numScanDirs*dims.x ) ;
+      buf.t.resize( numScanDirs*dims.x ) ;
+      for( int k = kBegin ; k < kEnd ; k++ )
+        for( int j = 0 ; j < dims.y ; j++ )
+          scanRow( j, k, buf ) ;
+    } ) ;
+
+    for( int idex = 0 ; idex < voxelGrid->voxels.size() ; idex++ )
+      punchthruStart[idex+1] += punchthruStart[idex] ;
+    punchthrus.reserve( punchthruStart.back() ) ;
+    for( int t = 0 ; t < numThreads ; t++ )
+    {
+      punchthrus.insert( punchthrus.end(), scanBuffers[t].hits.begin(), scanBuffers[t].hits.end() ) ;
+      verts->insert( verts->end(), scanBuffers[t].verts.begin(), scanBuffers[t].verts.end() ) ;
+    }
+  }
+
+  // central difference gradient of the field at voxel dex, in index space (wraps at borders)
+  Vector3f gradient( const Vector3i& dex ) const
+  {
+    Vector3f g ;
+    for( int axis = 0 ; axis < 3 ; axis++ )
+    {
+      Vector3i step ;
+      step[axis] = 1 ;
+      g.elts[axis] = ( (*voxelGrid)( dex + step ).v - (*voxelGrid)( dex - step ).v ) / 2 ;
+    }
+    return g ;
+  }
+
+  // Calls f( p, n, dv ) for every hit from the last scan, in order: its world space point,
+  // the field gradient there (lerped between the hit's 2 voxels) as a unit normal pointing
+  // towards the inSurface side, same as the normals on the extracted meshes,
+  // and the jump in value across the hit.
+  template <typename F>
+  void forEachHit( const F& f )
+  {
+    int idex = 0 ;
+    for( int k = 0 ; k < voxelGrid->dims.z ; k++ )
+    {
+      for( int j = 0 ; j < voxelGrid->dims.y ; j++ )
+      {
+        for( int i = 0 ; i < voxelGrid->dims.x ; i++, idex++ )
+        {
+          if( !numPunchthrus( idex ) )  skip ;
+
+          Vector3i dex( i,j,k ) ;
+          Vector3f g0 = gradient( dex ) ;
+          Vector3f voxelCenter = (voxelGrid->offset + dex)*voxelGrid->gridSizer ;
+          for( int h = punchthruStart[idex] ; h < punchthruStart[idex+1] ; h++ )
+          {
+            const IsosurfacePunchthru& hit = punchthrus[h] ;
+            const Vector3i& dir = Directions[ hit.directionIndex ] ;
+            Vector3f p2 = (voxelGrid->offset + dex + dir)*voxelGrid->gridSizer ;
+            Vector3f p = Vector3f::lerp( hit.t, voxelCenter, p2 ) ;
+            Vector3f g = Vector3f::lerp( hit.t, g0, gradient( dex + dir ) ) ;
+            Vector3f n = -(g / voxelGrid->gridSizer).normalize() ; // the gradient points away from inSurface
+            f( p, n, hit.dv ) ;
+          }
+        }
+      }
+    }
+  }
+
+  // Scans for the hits (without making visualization points) and gives
+  // their points and normals, eg for PointReconstruction.
+  void genHitPoints( vector<Vector3f>& pts, vector<Vector3f>& normals )
+  {
+    bool oldGenPoints = genPoints ;
+    genPoints = false ;
+    genVizPunchthru() ;
+    genPoints = oldGenPoints ;
+
+    pts.clear() ;
+    normals.clear() ;
+    pts.reserve( punchthrus.size() ) ;
+    normals.reserve( punchthrus.size() ) ;
+    forEachHit( [&]( const Vector3f& p, const Vector3f& n, float dv ) {
+      pts.push_back( p ) ;
+      normals.push_back( n ) ;
+    } ) ;
+  }
+
+  // Binary PLY of the punchthru points, for surface reconstruction tools:
+  // per vertex x y z nx ny nz dv, all floats, in world space (see forEachHit).
+  // Scans without making the visualization points and writes the vertices out a chunk at a time.
+  bool exportPLY( const char* filename )
+  {
+    FILE* f = fopen( filename, "wb" ) ;
+    if( !f )
+    {
+      printf( "Can't open '%s'\n", filename ) ;
+      return false ;
+    }
+
+    bool oldGenPoints = genPoints ;
+    genPoints = false ;
+    genVizPunchthru() ;
+    genPoints = oldGenPoints ;
+
+    // floats go out in this machine's byte order, so say which one that is
+    unsigned int one = 1 ;
+    bool littleEndian = *(unsigned char*)&one ;
+    fprintf( f, "ply\nformat %s 1.0\n", littleEndian ? "binary_little_endian" : "binary_big_endian" ) ;
+    fprintf( f, "comment isosurface %f\n", isosurface ) ;
+    fprintf( f, "element vertex %d\n", (int)punchthrus.size() ) ;
+    fprintf( f, "property float x\nproperty float y\nproperty float z\n" ) ;
+    fprintf( f, "property float nx\nproperty float ny\nproperty float nz\n" ) ;
+    fprintf( f, "property float dv\nend_header\n" ) ;
+
+    const int chunkVerts = 1<<14 ;
+    vector<float> chunk ;
+    chunk.reserve( 7*chunkVerts ) ;
+    forEachHit( [&]( const Vector3f& p, const Vector3f& n, float dv ) {
+      float vert[7] = { p.x, p.y, p.z, n.x, n.y, n.z, dv } ;
+      chunk.insert( chunk.end(), vert, vert+7 ) ;
+      if( chunk.size() == 7*chunkVerts )
+      {
+        fwrite( &chunk[0], sizeof(float), chunk.size(), f ) ;
+        chunk.clear() ;
+      }
+    } ) ;
+    if( chunk.size() )
+      fwrite( &chunk[0], sizeof(float), chunk.size(), f ) ;
+
+    fclose( f ) ;
+    printf( "Wrote %d points to '%s'\n", (int)punchthrus.size(), filename ) ;
+    return true ;
+  }
+
+  void addDirection( const Vector3i& v )
+  {
+    Directions.push_back( v ) ;
+    DirsNeighbours.push_back( vector<int>() ) ;
+  }
+
+  void addNeighbours( int forDirection, int* neighbours, int len )
+  {
+    if( forDirection >= DirsNeighbours.size() )
+    {
+      printf( "%d oob DirsNeighbours (%d)\n", forDirection, (int)DirsNeighbours.size() ) ;
+      return ;
+    }
+    for( int i = 0 ; i < len ; i++ )
+      DirsNeighbours[forDirection].push_back( neighbours[i] ) ;
+  }
+
+  void initDirections()
+  {
+    addDirection( Vector3i( 1, 0, 0 ) ) ;  //0
+    addDirection( Vector3i( 0, 1, 0 ) ) ;  //1
+    addDirection( Vector3i( 0, 0, 1 ) ) ;  //2
+  
+    addDirection( Vector3i( -1,  0,  0 ) ) ; //3
+    addDirection( Vector3i(  0, -1,  0 ) ) ; //4
+    addDirection( Vector3i(  0,  0, -1 ) ) ; //5
+
+    // UPPER NEIGHBOR, LEFT NEIGHBOUR,  LEFT NEIGHBOUR, LOWER NEIGHBOUR
+    int px[4] = { 1, 2,  2, 4 } ;
+    addNeighbours( 0, px, 4 ) ;
+  
+    // y has NO NEIGHBOURS listed.
+    int pz[4] = { 1, 3,  3, 4 } ;
+    addNeighbours( 2, pz, 4 ) ;
+
+    int nx[4] = { 1, 5,  5, 4 } ;
+    addNeighbours( 3, nx, 4 ) ;
+
+    int nz[4] = { 1, 0,  0, 4 } ;
+    addNeighbours( 5, nz, 4 ) ;
+
+    for( int d = 0 ; d < Directions.size() ; d++ )
+    {
+      opposite.push_back( -1 ) ;
+      for( int e = 0 ; e < Directions.size() ; e++ )
+        if( Directions[e] == -Directions[d] )
+          opposite[d] = e ;
+      // scan the first of each pair (and any direction without an opposite)
+      isScanDir.push_back( opposite[d] == -1 || d < opposite[d] ) ;
+      if( isScanDir[d] )
+        scanDirs.push_back( d ) ;
+    }
+
+    /*
+    for( int i = 0 ; i < Directions.size() ; i++ )
+    {
+      Vector3i p = Directions[i] + 1 ; // ADD ONE WHEN GETTING INDEX
+      printf( "(%d,%d,%d) index %d\n", p.x, p.y, p.z, p.index( 3, 3 ) ) ;
+    }
+    */
+  }
+
+  
+} ;
+
+
+// Point cloud vars.
+float PointCloud::ptSize=1.f, PointCloud::cubeSize=50.f ;
+bool PointCloud::useCubes=1 ;
+vector<int> PointCloud::punchthruStart ;
+vector<PointCloud::IsosurfacePunchthru> PointCloud::punchthrus ;
+vector<PointCloud::ScanBuffer> PointCloud::scanBuffers ;
+  
 #endif
\ No newline at end of file
@@ -0,0 +1,390 @@
+#ifndef POINTRECONSTRUCTION_H
+#define POINTRECONSTRUCTION_H
+
+#include "SpatialHash.h"
+
+// Turns a bare point cloud (points with normals, no field) into a triangle mesh.
+//
+// This is a local, per point cousin of ball pivoting: a triangle is only made if a ball of
+// radius `radius` can sit on its 3 points with no other point inside (so sampling sparser
+// than that leaves holes instead of bridging them).  But instead of rolling the ball along
+// a front (which is inherently serial), every point works out its own umbrella of triangles
+// independently, then the umbrellas vote:
+//
+// 1. Every point p takes its k nearest neighbours (within 2*radius), projects them onto
+//    its tangent plane, and finds its Voronoi cell in that plane by clipping with the
+//    bisector of each neighbour.  Neighbours that end up owning an edge of the cell are p's
+//    Delaunay neighbours, in order around p (its "fan").  2 consecutive fan neighbours make a
+//    triangle with p if the Voronoi vertex between them (the centre of the empty circle
+//    through all 3) is within `radius`.
+// 2. A triangle is kept if at least 2 of its 3 points made it, and it's output once,
+//    by the lowest numbered point that made it.
+// 3. Where neighbouring tangent planes disagree about a Delaunay flip, neither diagonal gets
+//    2 votes and a little triangle or quad shaped hole is left, so those get filled in.
+//
+// The work is done on a copy of the points in spatial hash order, so neighbours are
+// mostly near each other in memory.
+//
+// Both passes are parallel over the points, each thread writing its own buffer, and
+// the buffers are joined in thread order, so the output doesn't depend on the thread count.
+//
+// Triangles are wound so Triangle::triNormal agrees with the point normals, same as
+// the extractors' triangles.  If the points have no normals, estimateNormals makes some.
+struct PointReconstruction
+{
+  // a fan is at most this many neighbours (a bit each in fanTris)
+  static const int MaxFan = 32 ;
+
+  const vector<Vector3f>* pts ;
+  const vector<Vector3f>* normals ;
+  float radius ; // largest empty circle a triangle can have
+  int k ;        // # neighbours looked at per point
+
+  SpatialHash hash ;
+
+  // the points and normals in spatial order: sortedPts[s] is (*pts)[ order[s] ]
+  vector<Vector3f> sortedPts, sortedNormals ;
+  vector<int> order ;
+
+  // (these are all by sorted index)
+  // point i's fan is fanNbrs[ i*MaxFan ] .. fanNbrs[ i*MaxFan + fanLen[i]-1 ], counterclockwise around its normal.
+  // Bit m of fanTris[i] is set if ( i, fan[m], fan[m+1] ) is a triangle (m+1 wraps to 0).
+  vector<int> fanNbrs ;
+  vector<unsigned char> fanLen ;
+  vector<unsigned int> fanTris ;
+
+  PointReconstruction( const vector<Vector3f>* iPts, const vector<Vector3f>* iNormals, float iRadius, int iK=24 )
+  {
+    pts = iPts ;
+    normals = iNormals ;
+    radius = iRadius ;
+    k = min( iK, MaxFan ) ;
+  }
+
+  // Any 2 unit vectors perpendicular to n (and each other), with u x v = n.
+  static void tangentFrame( const Vector3f& n, Vector3f& u, Vector3f& v )
+  {
+    // cross with the axis n is least along
+    Vector3f a = fabsf( n.x ) < 0.6f ? Vector3f(1,0,0) : Vector3f(0,1,0) ;
+    u = a.cross( n ).normalize() ;
+    v = n.cross( u ) ;
+  }
+
+  // Builds point i's fan.
+  void buildFan( int i, int* nbrs, float* nbrDist2, vector<Vector2f>& poly, vector<int>& labels,
+    vector<Vector2f>& clipped, vector<int>& clippedLabels )
+  {
+    const Vector3f& p = sortedPts[i] ;
+    Vector3f u, v ;
+    tangentFrame( sortedNormals[i], u, v ) ;
+
+    // the search includes p itself
+    int found = hash.kNearest( p, k+1, 2*radius, nbrs, nbrDist2 ) ;
+
+    // p's Voronoi cell starts as a square that holds every empty circle we'd accept.
+    // labels[e] is the neighbour whose bisector made edge e (poly[e] to poly[e+1]), -1 for the square.
+    float s = 2*radius ;
+    poly.clear() ;  labels.clear() ;
+    poly.push_back( Vector2f( -s, -s ) ) ;  labels.push_back( -1 ) ;
+    poly.push_back( Vector2f(  s, -s ) ) ;  labels.push_back( -1 ) ;
+    poly.push_back( Vector2f(  s,  s ) ) ;  labels.push_back( -1 ) ;
+    poly.push_back( Vector2f( -s,  s ) ) ;  labels.push_back( -1 ) ;
+
+    float farthest2 = 8*s*s ; // the cell's farthest vertex (squared)
+    for( int m = 0 ; m < found ; m++ )
+    {
+      // The neighbours come nearest first, and one further than twice the cell's
+      // farthest vertex can't cut the cell, so none of the rest can either.
+      if( nbrDist2[m] > 4*farthest2 )  break ;
+      int j = nbrs[m] ;
+      if( j == i || nbrDist2[m] == 0.f )  skip ; // p itself, or a duplicate of it
+      Vector3f d = sortedPts[j] - p ;
+      Vector2f q( d.dot( u ), d.dot( v ) ) ;
+      float qq = q.dot( q ) ;
+      if( qq == 0.f )  skip ; // right above p
+
+      // keep the side of the bisector p is on: x.q <= |q|^2/2
+      clipped.clear() ;  clippedLabels.clear() ;
+      for( int e = 0 ; e < poly.size() ; e++ )
+      {
+        const Vector2f& A = poly[e] ;
+        const Vector2f& B = poly[ (e+1) % poly.size() ] ;
+        float dA = A.dot( q ) - qq/2, dB = B.dot( q ) - qq/2 ;
+        if( dA <= 0 )
+        {
+          clipped.push_back( A ) ;
+          clippedLabels.push_back( labels[e] ) ;
+          if( dB > 0 )
+          {
+            // leaving: from here to where the cell comes back in is along j's bisector
+            clipped.push_back( A + (B-A)*( dA/(dA-dB) ) ) ;
+            clippedLabels.push_back( j ) ;
+          }
+        }
+        else if( dB <= 0 )
+        {
+          // coming back in, along the original edge
+          clipped.push_back( A + (B-A)*( dA/(dA-dB) ) ) ;
+          clippedLabels.push_back( labels[e] ) ;
+        }
+      }
+      poly.swap( clipped ) ;
+      labels.swap( clippedLabels ) ;
+
+      farthest2 = 0 ;
+      for( int e = 0 ; e < poly.size() ; e++ )
+        farthest2 = max( farthest2, poly[e].len2() ) ;
+    }
+
+    // Walk the cell's edges counterclockwise.  The vertex between edge e and e+1 is
+    // the centre of the empty circle through p and those 2 edges' neighbours.
+    int* fan = &fanNbrs[ i*MaxFan ] ;
+    int len = 0 ;
+    unsigned int tris = 0 ;
+    int start = 0 ;
+    for( int e = 0 ; e < labels.size() ; e++ )
+      if( labels[e] == -1 )  { start = e ; break ; } // start on a square edge, if there is one
+    for( int c = 0 ; c < labels.size() && len < MaxFan ; c++ )
+    {
+      int e = (start + c) % labels.size() ;
+      if( labels[e] == -1 )  skip ;
+      // the next edge's neighbour is the next one in the fan (or wraps to fan[0] if
+      // the cell is closed), and if there's a square edge in between there's no triangle.
+      int next = (e+1) % labels.size() ;
+      if( labels[next] != -1 && poly[next].len2() <= radius*radius )
+        tris |= 1u << len ;
+      fan[ len++ ] = labels[e] ;
+    }
+    fanLen[i] = len ;
+    fanTris[i] = tris ;
+  }
+
+  // is ( i, a, b ) (either way around) one of point i's fan triangles?
+  bool fanHasTri( int i, int a, int b ) const
+  {
+    const int* fan = &fanNbrs[ i*MaxFan ] ;
+    int len = fanLen[i] ;
+    for( int m = 0 ; m < len ; m++ )
+    {
+      if( !( fanTris[i] & (1u<<m) ) )  skip ;
+      int x = fan[m], y = fan[ (m+1) % len ] ;
+      if( ( x == a && y == b ) || ( x == b && y == a ) )
+        return true ;
+    }
+    return false ;
+  }
+
+  // Fills indices with the triangles (3 per).
+  void reconstruct( vector<int>& indices )
+  {
+    int n = (int)pts->size() ;
+    indices.clear() ;
+    if( !n )  return ;
+
+    // hash once to get the spatial order, then again on the reordered copy
+    // (which comes out in the same order) so queries give sorted indices
+    hash.build( *pts, radius ) ;
+    order = hash.entries ;
+    sortedPts = hash.entryPts ;
+    sortedNormals.resize( n ) ;
+    for( int i = 0 ; i < n ; i++ )
+      sortedNormals[i] = (*normals)[ order[i] ] ;
+    hash.build( sortedPts, radius ) ;
+
+    fanNbrs.resize( n*MaxFan ) ;
+    fanLen.resize( n ) ;
+    fanTris.resize( n ) ;
+
+    int numThreads = min( numWorkerThreads(), n ) ;
+    parallelForChunks( n, numThreads, [&]( int, int begin, int end ) {
+      vector<int> nbrs( k+1 ) ;
+      vector<float> nbrDist2( k+1 ) ;
+      vector<Vector2f> poly, clipped ;
+      vector<int> labels, clippedLabels ;
+      for( int i = begin ; i < end ; i++ )
+        buildFan( i, &nbrs[0], &nbrDist2[0], poly, labels, clipped, clippedLabels ) ;
+    } ) ;
+
+    vector< vector<int> > threadTris( numThreads ) ;
+    parallelForChunks( n, numThreads, [&]( int threadIndex, int begin, int end ) {
+      vector<int>& out = threadTris[ threadIndex ] ;
+      for( int i = begin ; i < end ; i++ )
+      {
+        const int* fan = &fanNbrs[ i*MaxFan ] ;
+        int len = fanLen[i] ;
+        for( int m = 0 ; m < len ; m++ )
+        {
+          if( !( fanTris[i] & (1u<<m) ) )  skip ;
+          int j = fan[m], l = fan[ (m+1) % len ] ;
+          bool jVotes = fanHasTri( j, i, l ), lVotes = fanHasTri( l, i, j ) ;
+          if( !jVotes && !lVotes )  skip ; // only i thinks so
+          // the lowest numbered point that made it outputs it
+          if( ( jVotes && j < i ) || ( lVotes && l < i ) )  skip ;
+
+          // j to l is counterclockwise about i's normal, so ( i, l, j ) has triNormal along it
+          out.push_back( i ) ;
+          out.push_back( l ) ;
+          out.push_back( j ) ;
+        }
+      }
+    } ) ;
+
+    for( int t = 0 ; t < numThreads ; t++ )
+      indices.insert( indices.end(), threadTris[t].begin(), threadTris[t].end() ) ;
+
+    fillSmallHoles( indices ) ;
+
+    // back to the caller's point numbering
+    for( int i = 0 ; i < indices.size() ; i++ )
+      indices[i] = order[ indices[i] ] ;
+  }
+
+  // Fills boundary loops of 3 or 4 edges (the holes left where 2 fans disagreed
+  // about which way to split a quad).  A quad is split along its shorter diagonal.
+  void fillSmallHoles( vector<int>& indices )
+  {
+    int n = (int)sortedPts.size() ;
+    int numTris = (int)indices.size()/3 ;
+
+    // the half edges a->b, grouped by a (each tri ( a,b,c ) has a->b, b->c, c->a)
+    vector<int> outStart( n+1, 0 ) ;
+    for( int i = 0 ; i < indices.size() ; i++ )
+      outStart[ indices[i]+1 ]++ ;
+    for( int i = 0 ; i < n ; i++ )
+      outStart[i+1] += outStart[i] ;
+    vector<int> outTo( indices.size() ) ;
+    vector<int> fill( outStart.begin(), outStart.end()-1 ) ;
+    for( int t = 0 ; t < numTris ; t++ )
+      for( int e = 0 ; e < 3 ; e++ )
+        outTo[ fill[ indices[3*t+e] ]++ ] = indices[ 3*t + (e+1)%3 ] ;
+
+    // a->b is on the boundary if there's no b->a.
+    // Around a hole, the boundary half edges chain a->b->c.. with the hole on the outside of the tris.
+    // boundaryNext[a] is b for the 1 boundary half edge out of a (-1 if none, -2 if more than 1).
+    vector<int> boundaryNext( n, -1 ) ;
+    parallelFor( n, [&]( int a ) {
+      for( int h = outStart[a] ; h < outStart[a+1] ; h++ )
+      {
+        int b = outTo[h] ;
+        bool twin = false ;
+        for( int g = outStart[b] ; g < outStart[b+1] && !twin ; g++ )
+          twin = outTo[g] == a ;
+        if( !twin )
+          boundaryNext[a] = boundaryNext[a] == -1 ? b : -2 ;
+      }
+    } ) ;
+
+    for( int a = 0 ; a < n ; a++ )
+    {
+      int b = boundaryNext[a] ;
+      if( b < 0 )  skip ;
+      int c = boundaryNext[b] ;
+      if( c < 0 )  skip ;
+      int d = boundaryNext[c] ;
+      if( d == a && a < b && a < c )
+      {
+        // triangle hole a->b->c: the missing triangle has b->a, a->c, c->b
+        indices.push_back( a ) ;  indices.push_back( c ) ;  indices.push_back( b ) ;
+      }
+      else if( d >= 0 && boundaryNext[d] == a && a < b && a < c && a < d )
+      {
+        // quad hole a->b->c->d, filled as ( a,d,c,b ) split along a-c or b-d
+        if( ( sortedPts[a] - sortedPts[c] ).len2() <= ( sortedPts[b] - sortedPts[d] ).len2() )
+        {
+          indices.push_back( a ) ;  indices.push_back( d ) ;  indices.push_back( c ) ;
+          indices.push_back( a ) ;  indices.push_back( c ) ;  indices.push_back( b ) ;
+        }
+        else
+        {
+          indices.push_back( b ) ;  indices.push_back( a ) ;  indices.push_back( d ) ;
+          indices.push_back( b ) ;  indices.push_back( d ) ;  indices.push_back( c ) ;
+        }
+      }
+    }
+  }
+
+  // Unit eigenvector of the symmetric matrix ( a b c / b d e / c e f ) with the smallest eigenvalue.
+  static Vector3f smallestEigenvector( double a, double b, double c, double d, double e, double f )
+  {
+    // smallest eigenvalue, closed form for symmetric 3x3
+    double p1 = b*b + c*c + e*e ;
+    double q = (a+d+f)/3 ;
+    double p2 = (a-q)*(a-q) + (d-q)*(d-q) + (f-q)*(f-q) + 2*p1 ;
+    double p = sqrt( p2/6 ) ;
+    if( p == 0 )  return Vector3f(0,0,1) ; // every direction is the same
+    double Ba = (a-q)/p, Bd = (d-q)/p, Bf = (f-q)/p, Bb = b/p, Bc = c/p, Be = e/p ;
+    double r = ( Ba*(Bd*Bf - Be*Be) - Bb*(Bb*Bf - Be*Bc) + Bc*(Bb*Be - Bd*Bc) )/2 ;
+    r = r < -1 ? -1 : r > 1 ? 1 : r ;
+    double lambda = q + 2*p*cos( acos( r )/3 + 2*M_PI/3 ) ;
+
+    // the eigenvector is perpendicular to the rows of A - lambda I: take the best conditioned cross
+    Vector3f r0( a-lambda, b, c ), r1( b, d-lambda, e ), r2( c, e, f-lambda ) ;
+    Vector3f x0 = r0.cross( r1 ), x1 = r0.cross( r2 ), x2 = r1.cross( r2 ) ;
+    float l0 = x0.len2(), l1 = x1.len2(), l2 = x2.len2() ;
+    Vector3f best = l0 >= l1 && l0 >= l2 ? x0 : l1 >= l2 ? x1 : x2 ;
+    if( best.len2() == 0 )  return Vector3f(0,0,1) ;
+    return best.normalize() ;
+  }
+
+  // Normals for points that came without any: the least variance direction of each point's
+  // k nearest neighbours (within maxDist), flipped so neighbours agree with each other
+  // (spreading out from a seed per connected patch).  The side the normals end up on is arbitrary,
+  // flip them all if it's the wrong one.
+  static void estimateNormals( const vector<Vector3f>& points, float maxDist, int k, vector<Vector3f>& outNormals )
+  {
+    int n = (int)points.size() ;
+    SpatialHash hash ;
+    hash.build( points, maxDist ) ;
+    outNormals.resize( n ) ;
+    vector<int> nbrs( n*k ) ;
+    vector<unsigned char> numNbrs( n ) ;
+
+    parallelForChunks( n, numWorkerThreads(), [&]( int, int begin, int end ) {
+      for( int i = begin ; i < end ; i++ )
+      {
+        int* nb = &nbrs[ i*k ] ;
+        int found = hash.kNearest( points[i], k, maxDist, nb ) ;
+        numNbrs[i] = found ;
+
+        Vector3f mean ;
+        for( int m = 0 ; m < found ; m++ )
+          mean += points[ nb[m] ] ;
+        mean /= max( found, 1 ) ;
+        double a=0, b=0, c=0, d=0, e=0, f=0 ;
+        for( int m = 0 ; m < found ; m++ )
+        {
+          Vector3f r = points[ nb[m] ] - mean ;
+          a += r.x*r.x ;  b += r.x*r.y ;  c += r.x*r.z ;
+          d += r.y*r.y ;  e += r.y*r.z ;  f += r.z*r.z ;
+        }
+        outNormals[i] = smallestEigenvector( a, b, c, d, e, f ) ;
+      }
+    } ) ;
+
+    // make neighbouring normals agree, breadth first over the neighbour graph
+    vector<bool> done( n, false ) ;
+    vector<int> queue ;
+    for( int seed = 0 ; seed < n ; seed++ )
+    {
+      if( done[seed] )  skip ;
+      done[seed] = true ;
+      queue.clear() ;
+      queue.push_back( seed ) ;
+      for( int qi = 0 ; qi < queue.size() ; qi++ )
+      {
+        int i = queue[qi] ;
+        for( int m = 0 ; m < numNbrs[i] ; m++ )
+        {
+          int j = nbrs[ i*k + m ] ;
+          if( done[j] )  skip ;
+          if( outNormals[j].dot( outNormals[i] ) < 0 )
+            outNormals[j] = -outNormals[j] ;
+          done[j] = true ;
+          queue.push_back( j ) ;
+        }
+      }
+    }
+  }
+} ;
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef PROGRESSIVEMESH_H
+#define PROGRESSIVEMESH_H
+
+#include "Decimator.h"
+
+// A progressive mesh (Hoppe, "Progressive Meshes", 1996): the full res mesh, plus the
+// sequence of edge collapses the Decimator makes taking it all the way down, recorded once.
+// Any level of detail in between is then reached from the current one by replaying collapses
+// (coarser) or undoing them, ie vertex splits (finer), and each of those only touches the
+// handful of triangle corners and the 1 vertex it changed.
+//
+// The triangles are stored in the reverse of the order they die in, so the live triangles
+// at any level are always the first liveTris of indices, and the ones a collapse kills are
+// right after them.  The verts keep their numbering: a coarser level just stops using some.
+// So a level draws straight from verts and the first 3*liveTris of indices, and keeps the
+// order the triangles were in when it was built wherever the death order doesn't overrule it.
+struct ProgressiveMesh
+{
+  // collapse k, and what it takes to undo it (the vertex split)
+  struct Collapse
+  {
+    int from, to ;                // from merges into to
+    Vector3f toPos, toNormal ;    // to before the collapse
+    Vector3f newPos, newNormal ;  // to after
+    int liveTris ;                // live triangles before the collapse
+    int cornersStart ;            // its corners are corners[ cornersStart .. the next one's cornersStart )
+  } ;
+
+  vector<VertexPNCT> verts ;  // at the current level
+  vector<int> indices ;       // every triangle, at the current level, live ones first
+  vector<Collapse> collapses ;
+  vector<int> corners ;       // slots in indices that say from before their collapse, and to after
+  int level ;                 // how many collapses are applied
+  int liveTris ;
+  int coarsestTris ;          // live triangles with every collapse applied
+
+  ProgressiveMesh() : level(0), liveTris(0), coarsestTris(0)
+  {
+  }
+
+  int fullTris() const { return collapses.size() ? collapses[0].liveTris : liveTris ; }
+
+  int liveTrisAt( int k ) const { return k < collapses.size() ? collapses[k].liveTris : coarsestTris ; }
+
+  int cornersEnd( int k ) const { return k+1 < collapses.size() ? collapses[k+1].cornersStart : (int)corners.size() ; }
+
+  // Records the collapses of fine (indexed triangles), with the same wall locking and
+  // quadric costs as Decimator::decimate.  Starts at the full res level.
+  void build( const Mesh& fine, VoxelGrid* voxelGrid )
+  {
+    Mesh work ;
+    work.verts = fine.verts ;
+    work.indices = fine.indices ;
+    if( fine.vertexTrianglesBuilt() )
+    {
+      work.vertTris = fine.vertTris ;
+      work.vertTrisVersion = work.indicesVersion ;
+    }
+    int numTris = (int)fine.indices.size()/3 ;
+
+    vector<int> deathStep( numTris, INT_MAX ) ; // the collapse that kills each triangle
+    vector<int> triCorners ; // like corners, but 3*triangle+corner, in fine's triangle order
+    collapses.clear() ;
+
+    Decimator decimator( &work, voxelGrid ) ;
+    coarsestTris = decimator.collapseUntil( 0, HUGE_VALF, [&]( const Decimator::Collapse& col ) {
+      int k = (int)collapses.size() ;
+      const VertexPNCT& vTo = work.verts[ col.to ] ;
+      Collapse c ;
+      c.from = col.from, c.to = col.to ;
+      c.toPos = vTo.pos, c.toNormal = vTo.normal ;
+      c.newPos = col.target ;
+      c.newNormal = Decimator::mergedNormal( vTo.normal, work.verts[ col.from ].normal ) ;
+      c.liveTris = decimator.liveTris ;
+      c.cornersStart = (int)triCorners.size() ;
+      for( int t : decimator.trisOf( col.from ) )
+      {
+        if( decimator.triDead[t] )  skip ;
+        int* ixs = decimator.tri( t ) ;
+        if( ixs[0] == col.to || ixs[1] == col.to || ixs[2] == col.to )
+        {
+          deathStep[t] = k ;
+          skip ;
+        }
+        for( int corner = 0 ; corner < 3 ; corner++ )
+          if( ixs[corner] == col.from )
+            triCorners.push_back( 3*t + corner ) ;
+      }
+      collapses.push_back( c ) ;
+    } ) ;
+
+    // degenerate triangles the Decimator threw out before it started go last, and are never live
+    for( int t = 0 ; t < numTris ; t++ )
+      if( decimator.triDead[t] && deathStep[t] == INT_MAX )
+        deathStep[t] = -1 ;
+
+    // the ones that never die first, then the latest to die first
+    vector<int> order( numTris ) ;
+    for( int t = 0 ; t < numTris ; t++ )
+      order[t] = t ;
+    stable_sort( order.begin(), order.end(), [&]( int a, int b ) { return deathStep[a] > deathStep[b] ; } ) ;
+    vector<int> slotOf( numTris ) ;
+    indices.resize( 3*numTris ) ;
+    for( int s = 0 ; s < numTris ; s++ )
+    {
+      slotOf[ order[s] ] = s ;
+      for( int corner = 0 ; corner < 3 ; corner++ )
+        indices[ 3*s + corner ] = fine.indices[ 3*order[s] + corner ] ;
+    }
+    corners.resize( triCorners.size() ) ;
+    for( int i = 0 ; i < triCorners.size() ; i++ )
+      corners[i] = 3*slotOf[ triCorners[i]/3 ] + triCorners[i]%3 ;
+
+    verts = fine.verts ;
+    level = 0 ;
+    liveTris = liveTrisAt( 0 ) ;
+  }
+
+  // the next collapse (coarser)
+  void collapseNext()
+  {
+    const Collapse& c = collapses[level] ;
+    for( int i = c.cornersStart ; i < cornersEnd( level ) ; i++ )
+      indices[ corners[i] ] = c.to ;
+    verts[ c.to ].pos = c.newPos ;
+    verts[ c.to ].normal = c.newNormal ;
+    level++ ;
+    liveTris = liveTrisAt( level ) ;
+  }
+
+  // undoes the last collapse (finer)
+  void splitPrev()
+  {
+    level-- ;
+    const Collapse& c = collapses[level] ;
+    for( int i = c.cornersStart ; i < cornersEnd( level ) ; i++ )
+      indices[ corners[i] ] = c.from ;
+    verts[ c.to ].pos = c.toPos ;
+    verts[ c.to ].normal = c.toNormal ;
+    liveTris = c.liveTris ;
+  }
+
+  void setLevel( int k )
+  {
+    k = max( 0, min( k, (int)collapses.size() ) ) ;
+    while( level < k )  collapseNext() ;
+    while( level > k )  splitPrev() ;
+  }
+
+  // Goes to the finest level with at most numTris triangles (or the coarsest there is).
+  // Returns the number of triangles it has.
+  int setTriangleCount( int numTris )
+  {
+    // liveTrisAt only goes down with k
+    int lo = 0, hi = (int)collapses.size() ;
+    while( lo < hi )
+    {
+      int mid = ( lo + hi )/2 ;
+      if( liveTrisAt( mid ) <= numTris )  hi = mid ;
+      else  lo = mid + 1 ;
+    }
+    setLevel( lo ) ;
+    return liveTris ;
+  }
+
+  // Calls corner( slot ) for each slot of indices, and vertex( v ) for each of verts, that going
+  // from level from to the current one changed (some more than once), so a copy of the arrays
+  // made at level from is brought up to date in the time the level change took.
+  template <typename C, typename V>
+  void forChangedSince( int from, const C& corner, const V& vertex ) const
+  {
+    for( int k = min( from, level ) ; k < max( from, level ) ; k++ )
+    {
+      for( int i = collapses[k].cornersStart ; i < cornersEnd( k ) ; i++ )
+        corner( corners[i] ) ;
+      vertex( collapses[k].to ) ;
+    }
+  }
+} ;
+
+#endif
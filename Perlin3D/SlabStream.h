@@ -0,0 +1,120 @@
+#ifndef SLABSTREAM_H
+#define SLABSTREAM_H
+
+#include "MarchingCubes.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Streams the field through marching cubes one z-slab at a time,
+// so the whole voxel grid never has to exist at once.
+//
+// A producer thread generates slabs (VoxelGrid::genSlab) into a small ring buffer
+// while the calling thread marches each layer of cubes (MarchingCubes::marchSlabPair)
+// as soon as the 2 slabs it sits between are ready.  Each finished layer of triangles
+// goes straight out to a sink callback.
+//
+// Memory is ringSize+1 slabs of dims.x*dims.y floats (plus whatever the sink keeps),
+// so you can extract grids with a huge dims.z, or 4096x4096 slabs, without
+// the voxels array (36 bytes per voxel) ever being allocated.
+//
+// The grid wraps in z, so the last layer (dims.z-1 to dims.z) needs slab 0 again.
+// Slab 0 has long left the ring by then, so a copy of it is kept aside.
+struct SlabStream
+{
+  VoxelGrid *voxelGrid ; // only its dims and world transform are used
+  float w ;
+  int wPeriod ;
+
+  int ringSize ;
+  vector< vector<float> > ring ; // slab k lives in ring[ k % ringSize ]
+  vector<float> firstSlab ;      // copy of slab 0, for the last (wrapping) layer
+
+  // Producer/consumer counts.  The producer may write slab p once p < released + ringSize.
+  int produced ; // # slabs generated so far
+  int released ; // # slabs the consumer is done with
+  mutex m ;
+  condition_variable cv ;
+
+  SlabStream( VoxelGrid *iVoxelGrid, float iW, int iWPeriod, int iRingSize=4 )
+  {
+    voxelGrid = iVoxelGrid ;
+    w = iW ;
+    wPeriod = iWPeriod ;
+    ringSize = iRingSize ;
+    if( ringSize < 2 )  ringSize = 2 ; // each layer needs 2 slabs at once
+  }
+
+  void produce()
+  {
+    for( int k = 0 ; k < voxelGrid->dims.z ; k++ )
+    {
+      {
+        // wait for the slot slab k goes in to be released
+        unique_lock<mutex> lock( m ) ;
+        cv.wait( lock, [&]{ return k < released + ringSize ; } ) ;
+      }
+
+      voxelGrid->genSlab( k, &ring[ k % ringSize ][0], w, wPeriod ) ;
+
+      {
+        lock_guard<mutex> lock( m ) ;
+        produced = k+1 ;
+      }
+      cv.notify_all() ;
+    }
+  }
+
+  // Marches the whole grid with mc, using mc's isosurface and voxelGrid
+  // (mc's verts get pointed at each layer in turn).
+  // sink( k, layerVerts ) is called with the triangles of cube layer k (z=k to z=k+1) as soon as
+  // the layer is done, in order k=0..dims.z-1.  layerVerts is reused for the next layer,
+  // so the sink has to copy out whatever it wants to keep.
+  void run( MarchingCubes& mc, const function< void (int k, vector<VertexPNCT>& layerVerts) >& sink )
+  {
+    const Vector3i& dims = voxelGrid->dims ;
+    int slabSize = dims.x*dims.y ;
+    ring.resize( ringSize ) ;
+    for( int r = 0 ; r < ringSize ; r++ )
+      ring[r].resize( slabSize ) ;
+    produced = released = 0 ;
+
+    vector<VertexPNCT> layerVerts ;
+    vector<VertexPNCT>* origVerts = mc.verts ;
+    mc.verts = &layerVerts ;
+
+    thread producer( &SlabStream::produce, this ) ;
+
+    for( int k = 0 ; k < dims.z ; k++ )
+    {
+      bool last = k+1 == dims.z ;
+      {
+        // wait for slabs k and k+1 (for the last layer, slab k+1 IS slab 0)
+        unique_lock<mutex> lock( m ) ;
+        cv.wait( lock, [&]{ return produced >= ( last ? k+1 : k+2 ) ; } ) ;
+      }
+
+      if( !k )
+        firstSlab = ring[0] ;
+
+      const float* slab1 = last ? &firstSlab[0] : &ring[ (k+1) % ringSize ][0] ;
+      layerVerts.clear() ;
+      mc.marchSlabPair( &ring[ k % ringSize ][0], slab1, k ) ;
+
+      {
+        // slab k isn't needed again
+        lock_guard<mutex> lock( m ) ;
+        released = k+1 ;
+      }
+      cv.notify_all() ;
+
+      sink( k, layerVerts ) ;
+    }
+
+    producer.join() ;
+    mc.verts = origVerts ;
+  }
+} ;
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include "Vectorf.h"
+#include "Parallel.h"
+
+// A uniform grid over a set of points, hashed so only cells that have points cost anything.
+// The grid cells are cellSize on a side.  Cell (x,y,z) hashes into one of tableSize buckets,
+// and the points of each bucket are stored contiguously (compressed sparse rows),
+// so building is 2 linear passes (count, then scatter), and queries
+// just walk the buckets of the cells they overlap.
+//
+// Only the row (y,z) is hashed, and x is added on after, so a run of cells along x is
+// a run of buckets, and a query reads each row of cells it overlaps as 1 contiguous range.
+//
+// Different cells can hash to the same bucket, so points found in a bucket
+// are checked against the cells being searched.
+//
+// Make cellSize about the radius you query with most:
+// a radius query then looks at 27 cells at most.
+struct SpatialHash
+{
+  const vector<Vector3f>* pts ;
+  float cellSize, invCellSize ;
+  unsigned int tableMask ; // tableSize-1 (tableSize is a power of 2)
+
+  vector<int> bucketStart ; // tableSize+1 offsets into entries
+  vector<int> entries ;     // point indices, grouped by bucket
+  vector<Vector3f> entryPts ; // copies of the points in entries order, so walking a bucket doesn't jump around memory
+  Vector3i cellsLo, cellsHi ; // the range of cells that have points
+
+  // build's scratch, kept between builds so rebuilding a hash that's kept around doesn't allocate
+  vector<unsigned int> pointBucket ;
+  vector<int> fill ;
+  AtomicCounts counts ;
+  vector<int> threadSum ;
+  vector<Vector3i> threadLo, threadHi ;
+
+  SpatialHash() : pts(0), cellSize(1.f), invCellSize(1.f), tableMask(0)
+  {
+  }
+
+  static inline int floorInt( float x )
+  {
+    int i = (int)x ;
+    return i - ( x < i ) ;
+  }
+
+  inline Vector3i cellOf( const Vector3f& p ) const
+  {
+    return Vector3i( floorInt( p.x*invCellSize ), floorInt( p.y*invCellSize ), floorInt( p.z*invCellSize ) ) ;
+  }
+
+  inline unsigned int rowHash( int y, int z ) const
+  {
+    // spread the row's 2 cell coords over the bits (murmur3 finalizer)
+    unsigned int h = (unsigned int)y*19349663u ^ (unsigned int)z*83492791u ;
+    h ^= h >> 16 ;  h *= 0x85ebca6bu ;
+    h ^= h >> 13 ;  h *= 0xc2b2ae35u ;
+    h ^= h >> 16 ;
+    return h ;
+  }
+
+  inline unsigned int bucketOf( const Vector3i& c ) const
+  {
+    return ( rowHash( c.y, c.z ) + (unsigned int)c.x ) & tableMask ;
+  }
+
+  void build( const vector<Vector3f>& points, float iCellSize )
+  {
+    pts = &points ;
+    cellSize = iCellSize ;
+    invCellSize = 1.f / cellSize ;
+
+    // about 2 buckets per point keeps the chains short
+    unsigned int tableSize = 1 ;
+    while( tableSize < 2*points.size() )  tableSize <<= 1 ;
+    tableMask = tableSize - 1 ;
+
+    int n = (int)points.size() ;
+    vector<unsigned int>& bucket = pointBucket ;
+    bucket.resize( n ) ;
+    parallelFor( n, [&]( int i ) {
+      bucket[i] = bucketOf( cellOf( points[i] ) ) ;
+    } ) ;
+
+    // Count the points per bucket, prefix sum the counts into bucketStart, then scatter the points.
+    // On more than 1 thread, each thread counts and scatters its own chunk of the points through
+    // atomic counts, like VertexTriangles::build, so every pass is O(points/threads) or O(buckets/threads).
+    int numThreads = min( numWorkerThreads(), max( n, 1 ) ) ;
+    entries.resize( n ) ;
+    entryPts.resize( n ) ;
+    if( numThreads == 1 )
+    {
+      // (the same passes, without paying for the atomics: a locked add on a cache miss stalls)
+      bucketStart.assign( tableSize+1, 0 ) ;
+      for( int i = 0 ; i < n ; i++ )
+        bucketStart[ bucket[i]+1 ]++ ;
+      for( unsigned int b = 0 ; b < tableSize ; b++ )
+        bucketStart[b+1] += bucketStart[b] ;
+      fill.assign( bucketStart.begin(), bucketStart.end()-1 ) ;
+      for( int i = 0 ; i < n ; i++ )
+        entries[ fill[ bucket[i] ]++ ] = i ;
+    }
+    else
+    {
+      counts.reserve( tableSize ) ;
+      parallelFor( (int)tableSize, [&]( int b ) {
+        counts[b].store( 0, memory_order_relaxed ) ;
+      } ) ;
+      parallelFor( n, [&]( int i ) {
+        counts[ bucket[i] ].fetch_add( 1, memory_order_relaxed ) ;
+      } ) ;
+
+      // the prefix sum in 2 parallel passes: each thread sums its run of buckets,
+      // then writes its run's offsets, starting from the sum of the runs before it
+      bucketStart.resize( tableSize+1 ) ;
+      threadSum.assign( numThreads+1, 0 ) ;
+      parallelForChunks( (int)tableSize, numThreads, [&]( int t, int b0, int b1 ) {
+        int sum = 0 ;
+        for( int b = b0 ; b < b1 ; b++ )
+          sum += counts[b].load( memory_order_relaxed ) ;
+        threadSum[t+1] = sum ;
+      } ) ;
+      for( int t = 0 ; t < numThreads ; t++ )
+        threadSum[t+1] += threadSum[t] ;
+      parallelForChunks( (int)tableSize, numThreads, [&]( int t, int b0, int b1 ) {
+        int sum = threadSum[t] ;
+        for( int b = b0 ; b < b1 ; b++ )
+        {
+          bucketStart[b] = sum ;
+          sum += counts[b].load( memory_order_relaxed ) ;
+          counts[b].store( bucketStart[b], memory_order_relaxed ) ;
+        }
+      } ) ;
+      bucketStart[tableSize] = n ;
+
+      parallelFor( n, [&]( int i ) {
+        entries[ counts[ bucket[i] ].fetch_add( 1, memory_order_relaxed ) ] = i ;
+      } ) ;
+
+      // The threads scatter into a bucket in no particular order, so each goes back into point order
+      // (the order 1 thread puts them in).  Buckets hold about half a point: insertion sort.
+      parallelFor( (int)tableSize, [&]( int b ) {
+        for( int j = bucketStart[b]+1 ; j < bucketStart[b+1] ; j++ )
+        {
+          int e = entries[j], k = j ;
+          for( ; k > bucketStart[b] && entries[k-1] > e ; k-- )
+            entries[k] = entries[k-1] ;
+          entries[k] = e ;
+        }
+      } ) ;
+    }
+    parallelFor( n, [&]( int e ) {
+      entryPts[e] = points[ entries[e] ] ;
+    } ) ;
+
+    // the range of cells that have points: each thread finds it over its chunk of the points
+    threadLo.assign( numThreads, Vector3i( INT_MAX ) ) ;
+    threadHi.assign( numThreads, Vector3i( INT_MIN ) ) ;
+    parallelForChunks( n, numThreads, [&]( int t, int begin, int end ) {
+      for( int i = begin ; i < end ; i++ )
+      {
+        Vector3i c = cellOf( points[i] ) ;
+        for( int axis = 0 ; axis < 3 ; axis++ )
+        {
+          threadLo[t][axis] = min( threadLo[t][axis], c[axis] ) ;
+          threadHi[t][axis] = max( threadHi[t][axis], c[axis] ) ;
+        }
+      }
+    } ) ;
+    cellsLo = Vector3i( INT_MAX ), cellsHi = Vector3i( INT_MIN ) ;
+    for( int t = 0 ; t < numThreads ; t++ )
+    {
+      for( int axis = 0 ; axis < 3 ; axis++ )
+      {
+        cellsLo[axis] = min( cellsLo[axis], threadLo[t][axis] ) ;
+        cellsHi[axis] = max( cellsHi[axis], threadHi[t][axis] ) ;
+      }
+    }
+  }
+
+  // Frees the table and build's scratch (the hash is empty until the next build)
+  void release()
+  {
+    pts = 0 ;
+    tableMask = 0 ;
+    freeVector( bucketStart ) ;
+    freeVector( entries ) ;
+    freeVector( entryPts ) ;
+    freeVector( pointBucket ) ;
+    freeVector( fill ) ;
+    counts.release() ;
+    freeVector( threadSum ) ;
+    freeVector( threadLo ) ;
+    freeVector( threadHi ) ;
+  }
+
+  // Calls f( pointIndex, distance2, point ) for every point in cells (x0..x1,y,z) within sqrt(r2) of p.
+  // (f can shrink r2 as it goes.)
+  template <typename F>
+  inline void forRow( int x0, int x1, int y, int z, const Vector3f& p, const float& r2, const F& f ) const
+  {
+    unsigned int h = rowHash( y, z ) ;
+    for( int x = x0 ; x <= x1 ; )
+    {
+      // the buckets of x..x1 are contiguous until the table wraps
+      unsigned int b0 = ( h + (unsigned int)x ) & tableMask ;
+      int run = min( x1 - x + 1, (int)( tableMask - b0 ) + 1 ) ;
+      for( int e = bucketStart[b0] ; e < bucketStart[ b0+run ] ; e++ )
+      {
+        const Vector3f& q = entryPts[e] ;
+        float d2 = (q-p).len2() ;
+        if( d2 > r2 )  skip ;
+        Vector3i c = cellOf( q ) ;
+        if( c.y == y && c.z == z && c.x >= x && c.x < x+run )
+          f( entries[e], d2, q ) ;
+      }
+      x += run ;
+    }
+  }
+
+  // All the points within r of p (in no particular order) go in out.
+  void radius( const Vector3f& p, float r, vector<int>& out ) const
+  {
+    out.clear() ;
+    Vector3i lo = cellOf( p - r ), hi = cellOf( p + r ) ;
+    float r2 = r*r ;
+    for( int z = lo.z ; z <= hi.z ; z++ )
+      for( int y = lo.y ; y <= hi.y ; y++ )
+        forRow( lo.x, hi.x, y, z, p, r2, [&]( int i, float d2, const Vector3f& q ) {
+          out.push_back( i ) ;
+        } ) ;
+  }
+
+  // The (up to) k nearest points to p that are within maxDist, nearest first, go in out
+  // (and their squared distances in outDist2, if you pass it).  Returns how many were found.
+  // Searches outwards a shell of cells at a time, and stops as soon as the shells left
+  // can't hold anything nearer than the k'th point found.
+  int kNearest( const Vector3f& p, int k, float maxDist, int* out, float* outDist2=0 ) const
+  {
+    // (an empty hash has no range of cells to search, see build)
+    if( k <= 0 || entries.empty() )  return 0 ;
+
+    // (on the stack for the usual small k, since this is called per point from parallel loops)
+    float stackDist2[64] ;
+    vector<float> heapDist2 ;
+    if( !outDist2 )
+    {
+      if( k <= 64 )  outDist2 = stackDist2 ;
+      else
+      {
+        heapDist2.resize( k ) ;
+        outDist2 = &heapDist2[0] ;
+      }
+    }
+
+    int found = 0 ;
+    float maxDist2 = maxDist*maxDist ; // once k are found, this is the k'th one's distance
+    // keeps out/outDist2 sorted nearest first (insertion, k is small)
+    auto offer = [&]( int i, float d2, const Vector3f& q ) {
+      if( found == k && d2 >= outDist2[k-1] )  return ;
+      int j = found < k ? found++ : k-1 ;
+      for( ; j > 0 && outDist2[j-1] > d2 ; j-- )
+      {
+        out[j] = out[j-1] ;
+        outDist2[j] = outDist2[j-1] ;
+      }
+      out[j] = i ;
+      outDist2[j] = d2 ;
+      if( found == k )
+        maxDist2 = outDist2[k-1] ;
+    } ;
+
+    Vector3i c = cellOf( p ) ;
+    // how far p is from the nearest face of its own cell
+    Vector3f inCell = p*invCellSize - Vector3f( c ) ;
+    float edge = min( min( min( inCell.x, 1.f-inCell.x ), min( inCell.y, 1.f-inCell.y ) ), min( inCell.z, 1.f-inCell.z ) )*cellSize ;
+
+    // no further out than maxDist, or than the last cell with points in it
+    int maxRing = 0 ;
+    for( int axis = 0 ; axis < 3 ; axis++ )
+      maxRing = max( maxRing, max( c[axis] - cellsLo[axis], cellsHi[axis] - c[axis] ) ) ;
+    if( maxDist*invCellSize < maxRing )
+      maxRing = (int)ceilf( maxDist*invCellSize ) ;
+    for( int ring = 0 ; ring <= maxRing ; ring++ )
+    {
+      // the cells on the surface of the (2*ring+1)^3 cube around c:
+      // whole rows on the y and z faces, just the 2 end cells of the rows in between
+      for( int z = -ring ; z <= ring ; z++ )
+      {
+        for( int y = -ring ; y <= ring ; y++ )
+        {
+          if( abs( z ) == ring || abs( y ) == ring )
+            forRow( c.x-ring, c.x+ring, c.y+y, c.z+z, p, maxDist2, offer ) ;
+          else
+          {
+            forRow( c.x-ring, c.x-ring, c.y+y, c.z+z, p, maxDist2, offer ) ;
+            forRow( c.x+ring, c.x+ring, c.y+y, c.z+z, p, maxDist2, offer ) ;
+          }
+        }
+      }
+
+      // every point not searched yet is at least this far away
+      float searched = ring*cellSize + edge ;
+      if( found == k && outDist2[k-1] <= searched*searched )
+        break ;
+    }
+    return found ;
+  }
+} ;
+
+#endif
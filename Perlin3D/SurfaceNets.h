@@ -0,0 +1,243 @@
+#ifndef SURFACENETS_H
+#define SURFACENETS_H
+
+#include "MarchingCommon.h"
+
+// Dual isosurface extraction (surface nets).
+//
+// Marching cubes puts its vertices ON the grid edges, and each cube makes its own
+// little fan of triangles, so you get lots of slivers (that smoothMesh then has to clean up).
+// Surface nets works the other way around:
+//   - every cell the isosurface passes through gets ONE vertex, somewhere inside the cell
+//   - every grid edge the isosurface cuts gets ONE quad, joining the vertices
+//     of the 4 cells that share that edge
+// So vertices are shared by construction, and it writes an indexed mesh directly
+// (no createIndexBuffer()/smoothMesh() needed).
+//
+// Where the vertex goes in its cell:
+//   - naive surface nets: the average of the cell's edge cut points (the "mass point")
+//   - dual contouring (dualContour=1): the point that best fits the tangent planes
+//     at the cut points (least squares, the "QEF"), which keeps sharp features sharp.
+//     It's pulled a little toward the mass point so it doesn't fly off when the
+//     planes are (nearly) parallel, and it's clamped to the cell.
+//
+// The grid WRAPS, so cells on the +walls connect to cells on the -walls.  A quad that
+// reaches across a +wall uses a copy of the -wall cell's vertex, moved +worldSize.
+struct SurfaceNets : public IsosurfaceFinder
+{
+  bool dualContour ;
+
+  // how hard the QEF solution is pulled towards the mass point
+  float qefBias ;
+
+  // Pointer to the index array in caller program space
+  vector<int> *indices ;
+
+  // vertex index of each cell, for cells 0..dims on each axis ((dims+1)^3 of them).
+  // Cell `dims` on an axis is the wrapped copy of cell 0.
+  // -1 means the surface doesn't pass through the cell (or the copy hasn't been made yet).
+  vector<int> cellVerts ;
+  Vector3i cellDims ;
+
+  SurfaceNets( VoxelGrid *iVoxelGrid, vector<VertexPNCT>* iVerts, vector<int>* iIndices, float iIsosurface, const Vector4f& color ) :
+    IsosurfaceFinder( iVoxelGrid, iVerts, iIsosurface, color )
+  {
+    indices = iIndices ;
+    dualContour = 0 ;
+    qefBias = 0.05f ;
+  }
+
+  // corner i of a cell, in the same order MarchingCubes uses
+  inline static Vector3i corner( int i )
+  {
+    return Vector3i( (i>>2)&1, (i>>1)&1, i&1 ) ;
+  }
+
+  inline int cellIndex( const Vector3i& c ) const
+  {
+    return c.x + c.y*cellDims.x + c.z*cellDims.x*cellDims.y ;
+  }
+
+  // gradient of the trilinear interpolation of the 8 corner values
+  // at p (p is in the cell's local [0,1]^3 space)
+  static Vector3f gradient( const float vals[8], const Vector3f& p )
+  {
+    Vector3f g ;
+    for( int i = 0 ; i < 8 ; i++ )
+    {
+      Vector3i c = corner( i ) ;
+      // weight of corner i along each axis
+      float wx = c.x ? p.x : 1-p.x ;
+      float wy = c.y ? p.y : 1-p.y ;
+      float wz = c.z ? p.z : 1-p.z ;
+      g.x += vals[i] * (c.x ? 1 : -1) * wy*wz ;
+      g.y += vals[i] * (c.y ? 1 : -1) * wx*wz ;
+      g.z += vals[i] * (c.z ? 1 : -1) * wx*wy ;
+    }
+    return g ;
+  }
+
+  // Solves (ATA + qefBias*I) x = ATb + qefBias*mass by Cramer's rule.
+  // ATA is symmetric, so its rows are its columns.
+  Vector3f solveQEF( const Vector3f ATA[3], const Vector3f& ATb, const Vector3f& mass )
+  {
+    Vector3f c0 = ATA[0] + Vector3f(qefBias,0,0),
+             c1 = ATA[1] + Vector3f(0,qefBias,0),
+             c2 = ATA[2] + Vector3f(0,0,qefBias) ;
+    Vector3f b = ATb + mass*qefBias ;
+    float det = c0.dot( c1.cross( c2 ) ) ;
+    if( fabsf( det ) < 1e-12f )  return mass ;
+    return Vector3f( b.dot( c1.cross( c2 ) ), c0.dot( b.cross( c2 ) ), c0.dot( c1.cross( b ) ) ) / det ;
+  }
+
+  // Finds the vertex of cell c (c in 0..dims-1) in the cell's local [0,1]^3 space,
+  // and its normal in world space.
+  // Returns false if the surface doesn't pass through the cell.
+  bool cellVertex( const Vector3i& c, Vector3f& local, Vector3f& normal )
+  {
+    float vals[8] ;
+    int inMask = 0 ;
+    for( int i = 0 ; i < 8 ; i++ )
+    {
+      vals[i] = (*voxelGrid)( c + corner(i) ).v ;
+      if( inSurface( vals[i] ) )  inMask |= 1<<i ;
+    }
+    if( !inMask || inMask == 255 )  return false ; // all out or all in
+
+    Vector3f mass, ATA[3], ATb ;
+    normal = Vector3f() ;
+    int n = 0 ;
+
+    // The 12 cell edges are the corner pairs (a, a|bit) that differ in 1 bit.
+    for( int a = 0 ; a < 8 ; a++ )
+    {
+      for( int bit = 1 ; bit < 8 ; bit <<= 1 )
+      {
+        if( a & bit )  skip ;
+        int b = a | bit ;
+        if( ((inMask>>a)&1) == ((inMask>>b)&1) )  skip ; // edge doesn't cross the surface
+
+        float t = unlerp( isosurface, vals[a], vals[b] ) ;
+        Vector3f p = Vector3f::lerp( t, Vector3f( corner(a) ), Vector3f( corner(b) ) ) ;
+        mass += p ;
+        n++ ;
+
+        // The gradient points away from the inSurface side (inSurface is v < isosurface).
+        // Normals here point the same way Triangle::triNormal gives them for
+        // the other extractors' tris, towards the inSurface side, hence the -.
+        Vector3f g = gradient( vals, p ) ;
+        normal -= (g / voxelGrid->gridSizer).normalize() ;
+
+        if( dualContour )
+        {
+          // plane through p with normal g (in local space, the QEF lives in the cell)
+          g.normalize() ;
+          for( int row = 0 ; row < 3 ; row++ )
+            ATA[row] += g * g.elts[row] ;
+          ATb += g * g.dot( p ) ;
+        }
+      }
+    }
+
+    mass /= n ;
+    normal.normalize() ;
+
+    if( dualContour )
+      local = solveQEF( ATA, ATb, mass ).clampComponent( 0.f, 1.f ) ;
+    else
+      local = mass ;
+    return true ;
+  }
+
+  // Gets the vertex index for cell c (c in 0..dims on each axis),
+  // making the translated copy of a wrapped cell's vertex if it's needed.
+  int getCellVertex( const Vector3i& c )
+  {
+    int &vi = cellVerts[ cellIndex( c ) ] ;
+    if( vi != -1 )  return vi ;
+
+    // c is a +wall copy (an interior cell with no vertex never gets asked for,
+    // since it has no cut edges).
+    Vector3i wrapped = c ;
+    voxelGrid->wrappedIndex( wrapped ) ;
+    int base = cellVerts[ cellIndex( wrapped ) ] ;
+    if( base == -1 )
+    {
+      printf( "ERROR: SURFACE NETS CELL (%d,%d,%d) HAS NO VERTEX\n", wrapped.x, wrapped.y, wrapped.z ) ;
+      return 0 ;
+    }
+
+    VertexPNCT copy = (*verts)[ base ] ;
+    copy.pos += Vector3f( c - wrapped ) * voxelGrid->gridSizer ; // +worldSize on the wrapped axes
+    vi = (int)verts->size() ;
+    verts->push_back( copy ) ;
+    return vi ;
+  }
+
+  void genVizSurfaceNets()
+  {
+    Vector3i dims = voxelGrid->dims ;
+    cellDims = dims + 1 ;
+    cellVerts.clear() ;
+    cellVerts.resize( cellDims.x*cellDims.y*cellDims.z, -1 ) ;
+
+    // One vertex per cell that the isosurface passes through
+    for( int k = 0 ; k < dims.z ; k++ )
+    {
+      for( int j = 0 ; j < dims.y ; j++ )
+      {
+        for( int i = 0 ; i < dims.x ; i++ )
+        {
+          Vector3i c( i,j,k ) ;
+          Vector3f local, normal ;
+          if( !cellVertex( c, local, normal ) )  skip ;
+
+          cellVerts[ cellIndex( c ) ] = (int)verts->size() ;
+          Vector3f pos = ( voxelGrid->offset + Vector3f( c ) + local ) * voxelGrid->gridSizer ;
+          verts->push_back( VertexPNCT( pos, normal, baseColor ) ) ;
+        }
+      }
+    }
+
+    // One quad per grid edge that cuts the isosurface.
+    // The edge from voxel p to p+1 along `axis` is shared by the 4 cells
+    // p, p-u, p-v, p-u-v (u,v the other 2 axes).  Running p 1..dims on u and v
+    // keeps those cells in 0..dims, and visits every (wrapped) edge once.
+    for( int axis = 0 ; axis < 3 ; axis++ )
+    {
+      int u = OTHERAXIS1( axis ), v = OTHERAXIS2( axis ) ;
+      Vector3i eAxis, eU, eV ;
+      eAxis[axis] = eU[u] = eV[v] = 1 ;
+
+      for( int k = 0 ; k <= dims.z ; k++ )
+      {
+        for( int j = 0 ; j <= dims.y ; j++ )
+        {
+          for( int i = 0 ; i <= dims.x ; i++ )
+          {
+            Vector3i p( i,j,k ) ;
+            if( p[axis] == dims[axis] || !p[u] || !p[v] )  skip ;
+
+            bool in0 = inSurface( (*voxelGrid)( p ).v ) ;
+            bool in1 = inSurface( (*voxelGrid)( p + eAxis ).v ) ;
+            if( in0 == in1 )  skip ;
+
+            int c00 = getCellVertex( p - eU - eV ),
+                c10 = getCellVertex( p - eV ),
+                c11 = getCellVertex( p ),
+                c01 = getCellVertex( p - eU ) ;
+
+            // (c00,c10,c11,c01) is CCW looking down -axis, so it faces +axis:
+            // out of the surface when the inside is at p.
+            if( !in0 )  swap( c10, c01 ) ;
+
+            indices->push_back( c00 ) ;  indices->push_back( c10 ) ;  indices->push_back( c11 ) ;
+            indices->push_back( c00 ) ;  indices->push_back( c11 ) ;  indices->push_back( c01 ) ;
+          }
+        }
+      }
+    }
+  }
+} ;
+
+#endif
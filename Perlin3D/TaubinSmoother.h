@@ -0,0 +1,154 @@
+#ifndef TAUBINSMOOTHER_H
+#define TAUBINSMOOTHER_H
+
+#include "Mesh.h"
+
+// Taubin's lambda|mu smoothing ("A Signal Processing Approach to Fair Surface Design", 1995):
+// each pass moves every vertex towards the average of its neighbours (the umbrella operator)
+// by lambda, then back out by mu (negative, and a bit bigger than lambda), which takes
+// the marching cubes stair steps off without shrinking the mesh the way plain averaging does.
+//
+// The passes are Jacobi style: every vertex reads the positions from before the step and
+// writes to the other buffer, so all the verts update at once, in parallel, in any order.
+//
+// The periodic walls stay seamless: a vertex on a wall and its twins across the walls
+// (vNeighbours, from gatherEdgeData) are 1 vertex of the tiled surface, so they pool their
+// neighbours and all move by the same amount, and never off the walls they're on.
+struct TaubinSmoother
+{
+  Mesh* mesh ;
+  VoxelGrid* voxelGrid ;
+
+  VertexNeighbours neighbours ;
+  vector<int> twinsStart, twins ; // vertex i's copies across the walls: twins[ twinsStart[i] .. twinsStart[i+1] )
+  vector<char> lockedAxes ;       // bit a set: vertex i is on a wall across axis a, and stays on it
+  vector<Vector3f> pos[2] ;       // the double buffer
+  vector<Vector3f> sum ;          // per vertex, the sum of (neighbour - vertex)
+  vector<int> count ;             // and how many neighbours went into it
+  vector<int> group ;             // setup's scratch: 1 vertex's twins
+
+  TaubinSmoother( Mesh* iMesh, VoxelGrid* iVoxelGrid ) : mesh( iMesh ), voxelGrid( iVoxelGrid )
+  {
+  }
+
+  // the twins of vertex i: across each of its walls, and across those twins' walls (edges and corners)
+  void gatherTwins( int i, vector<int>& out ) const
+  {
+    out.clear() ;
+    out.push_back( i ) ;
+    for( int k = 0 ; k < out.size() ; k++ )
+      for( int twin : mesh->vNeighbours[ out[k] ] )
+        if( twin != -1 && find( out.begin(), out.end(), twin ) == out.end() )
+          out.push_back( twin ) ;
+    out.erase( out.begin() ) ;
+  }
+
+  void setup()
+  {
+    int numVerts = (int)mesh->verts.size() ;
+    mesh->gatherEdgeData( voxelGrid ) ;
+    neighbours.build( mesh->indices, mesh->vertexTriangles() ) ;
+
+    lockedAxes.assign( numVerts, 0 ) ;
+    parallelFor( numVerts, [&]( int i ) {
+      for( int wall = 0 ; wall < 6 ; wall++ )
+        if( mesh->verts[i].pos.elts[ wall/2 ] == voxelGrid->wallValue( wall ) ) // gatherEdgeData snapped them
+          lockedAxes[i] |= 1 << wall/2 ;
+    } ) ;
+
+    // only the verts on the walls have twins, so this is small
+    twinsStart.assign( numVerts+1, 0 ) ;
+    twins.clear() ;
+    for( int i = 0 ; i < numVerts ; i++ )
+    {
+      if( !mesh->vNeighbours[i].empty() )
+      {
+        gatherTwins( i, group ) ;
+        twins.insert( twins.end(), group.begin(), group.end() ) ;
+      }
+      twinsStart[i+1] = (int)twins.size() ;
+    }
+
+    pos[0].resize( numVerts ) ;
+    pos[1].resize( numVerts ) ;
+    sum.resize( numVerts ) ;
+    count.resize( numVerts ) ;
+    parallelFor( numVerts, [&]( int i ) {
+      pos[0][i] = mesh->verts[i].pos ;
+    } ) ;
+  }
+
+  // 1 Jacobi step of factor*umbrella, from src into dst
+  void step( const vector<Vector3f>& src, vector<Vector3f>& dst, float factor )
+  {
+    int numVerts = (int)src.size() ;
+    parallelFor( numVerts, [&]( int i ) {
+      Vector3f s ;
+      const Vector3f& p = src[i] ;
+      for( int q : neighbours[i] )
+        s += src[q] - p ;
+      sum[i] = s ;
+      count[i] = neighbours[i].size() ;
+    } ) ;
+
+    parallelFor( numVerts, [&]( int i ) {
+      Vector3f s = sum[i] ;
+      int n = count[i] ;
+      // a wall vertex pools with its twins (the offsets don't care which copy they're from)
+      for( int k = twinsStart[i] ; k < twinsStart[i+1] ; k++ )
+      {
+        s += sum[ twins[k] ] ;
+        n += count[ twins[k] ] ;
+      }
+      Vector3f move = n ? s*( factor/n ) : Vector3f() ;
+      for( int axis = 0 ; axis < 3 ; axis++ )
+        if( lockedAxes[i] & ( 1 << axis ) )
+          move.elts[axis] = 0 ;
+      dst[i] = src[i] + move ;
+    } ) ;
+  }
+
+  // The normals again from the smoothed triangles (area weighted, and pooled with the twins like the positions)
+  void renormal()
+  {
+    int numVerts = (int)mesh->verts.size() ;
+    const VertexTriangles& vertTris = mesh->vertexTriangles() ;
+    parallelFor( numVerts, [&]( int i ) {
+      Vector3f n ;
+      for( int t : vertTris[i] )
+      {
+        const int* ixs = &mesh->indices[3*t] ;
+        const Vector3f& a = mesh->verts[ ixs[0] ].pos ;
+        const Vector3f& b = mesh->verts[ ixs[1] ].pos ;
+        const Vector3f& c = mesh->verts[ ixs[2] ].pos ;
+        n += ( a-b ).cross( c-b ) ; // Triangle::triNormal's winding, which the marched normals agree with
+      }
+      sum[i] = n ;
+    } ) ;
+    parallelFor( numVerts, [&]( int i ) {
+      Vector3f n = sum[i] ;
+      for( int k = twinsStart[i] ; k < twinsStart[i+1] ; k++ )
+        n += sum[ twins[k] ] ;
+      if( n.len2() > 0 )
+        mesh->verts[i].normal = n.normalize() ;
+    } ) ;
+  }
+
+  // passes lambda|mu pairs.  mu = -0.53 with lambda = 0.5 passes frequencies below about 0.1.
+  void smooth( int passes, float lambda=0.5f, float mu=-0.53f )
+  {
+    if( passes <= 0 || mesh->indices.empty() )  return ;
+    setup() ;
+    for( int p = 0 ; p < passes ; p++ )
+    {
+      step( pos[0], pos[1], lambda ) ;
+      step( pos[1], pos[0], mu ) ;
+    }
+    parallelFor( (int)mesh->verts.size(), [&]( int i ) {
+      mesh->verts[i].pos = pos[0][i] ;
+    } ) ;
+    renormal() ;
+  }
+} ;
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef VERTEXTRIANGLES_H
+#define VERTEXTRIANGLES_H
+
+#include "Parallel.h"
+#include <atomic>
+
+// Which triangles use each vertex, as compressed rows: vertex v's triangles are
+// tris[ start[v] .. start[v+1] ), in increasing order (a triangle that uses v
+// twice is in its row twice).  2 flat arrays, so there's no allocation per vertex,
+// and the whole thing copies in 2 memcpys.
+struct VertexTriangles
+{
+  vector<int> start ; // numVerts+1 offsets into tris
+  vector<int> tris ;  // triangle numbers, grouped by vertex
+  AtomicCounts fill ; // build's scratch (it isn't copied with the rows)
+
+  struct Row
+  {
+    const int *b, *e ;
+    const int* begin() const { return b ; }
+    const int* end() const { return e ; }
+    int size() const { return (int)( e - b ) ; }
+  } ;
+
+  // for( int t : vertTris[v] )
+  Row operator[]( int v ) const
+  {
+    Row row = { tris.data() + start[v], tris.data() + start[v+1] } ;
+    return row ;
+  }
+
+  int numVerts() const { return start.empty() ? 0 : (int)start.size()-1 ; }
+
+  // O(indices) and parallel: count each vertex's corners, prefix sum, scatter, then
+  // sort each row, since the threads scatter into a row in no particular order.
+  void build( const vector<int>& indices, int numVerts )
+  {
+    int numCorners = (int)indices.size() ;
+    fill.reserve( numVerts ) ;
+    parallelFor( numVerts, [&]( int v ) {
+      fill[v].store( 0, memory_order_relaxed ) ;
+    } ) ;
+    parallelFor( numCorners, [&]( int i ) {
+      fill[ indices[i] ].fetch_add( 1, memory_order_relaxed ) ;
+    } ) ;
+
+    start.resize( numVerts+1 ) ;
+    start[0] = 0 ;
+    for( int v = 0 ; v < numVerts ; v++ )
+    {
+      start[v+1] = start[v] + fill[v].load( memory_order_relaxed ) ;
+      fill[v].store( start[v], memory_order_relaxed ) ;
+    }
+
+    tris.resize( numCorners ) ;
+    parallelFor( numCorners, [&]( int i ) {
+      tris[ fill[ indices[i] ].fetch_add( 1, memory_order_relaxed ) ] = i/3 ;
+    } ) ;
+
+    // rows are short (6 or so), so insertion sort
+    parallelFor( numVerts, [&]( int v ) {
+      for( int j = start[v]+1 ; j < start[v+1] ; j++ )
+      {
+        int t = tris[j], k = j ;
+        for( ; k > start[v] && tris[k-1] > t ; k-- )
+          tris[k] = tris[k-1] ;
+        tris[k] = t ;
+      }
+    } ) ;
+  }
+} ;
+
+// The verts joined to each vertex by an edge, as compressed rows like VertexTriangles:
+// vertex v's neighbours are verts[ start[v] .. start[v+1] ), in the order its triangles
+// first mention them.  Built from the triangles per vertex, in parallel.
+struct VertexNeighbours
+{
+  vector<int> start ;
+  vector<int> verts ;
+  vector<int> upTo, count ; // build's scratch, kept for the next build
+
+  VertexTriangles::Row operator[]( int v ) const
+  {
+    VertexTriangles::Row row = { verts.data() + start[v], verts.data() + start[v+1] } ;
+    return row ;
+  }
+
+  void build( const vector<int>& indices, const VertexTriangles& vertTris )
+  {
+    int numVerts = vertTris.numVerts() ;
+    // a vertex has at most 2 neighbours per triangle, so first each gets
+    // room for that (at 2*vertTris.start[v]) and its distinct neighbours are gathered there
+    upTo.resize( 2*vertTris.tris.size() ) ;
+    count.resize( numVerts ) ;
+    parallelFor( numVerts, [&]( int v ) {
+      int* row = upTo.data() + 2*vertTris.start[v] ;
+      int n = 0 ;
+      for( int t : vertTris[v] )
+        for( int c = 0 ; c < 3 ; c++ )
+        {
+          int q = indices[3*t+c] ;
+          if( q == v )  skip ;
+          int k = 0 ;
+          while( k < n && row[k] != q )  k++ ;
+          if( k == n )
+            row[n++] = q ;
+        }
+      count[v] = n ;
+    } ) ;
+
+    start.resize( numVerts+1 ) ;
+    start[0] = 0 ;
+    for( int v = 0 ; v < numVerts ; v++ )
+      start[v+1] = start[v] + count[v] ;
+    verts.resize( start[numVerts] ) ;
+    parallelFor( numVerts, [&]( int v ) {
+      const int* row = upTo.data() + 2*vertTris.start[v] ;
+      for( int k = 0 ; k < count[v] ; k++ )
+        verts[ start[v] + k ] = row[k] ;
+    } ) ;
+  }
+} ;
+
+#endif
@@ -0,0 +1,304 @@
+#ifndef VOLUMEMESH_H
+#define VOLUMEMESH_H
+
+#include "Vectorf.h"
+#include <vector>
+#include <algorithm>
+#include <string.h>
+using namespace std ;
+
+// A tetrahedral volume mesh: welded nodes, tets, and which tet is across each face.
+// SolidMarchingTets builds one through VolumeMeshSink (see MarchingTets.h), and it exports to
+// VTK (legacy binary unstructured grid) or Medit (.mesh), for physics/FEM.
+struct VolumeMesh
+{
+  vector<Vector3f> nodes ;
+
+  // 4 node indices per tet, wound so the volume is positive:
+  // (n1-n0)x(n2-n0) points towards n3 (the VTK/Medit convention)
+  vector<int> tets ;
+
+  // 4 per tet: the tet across face f (the face opposite node f), -1 on the boundary.
+  // Only valid after buildNeighbours().
+  vector<int> neighbours ;
+
+  // Welding.  Marching tets always computes a cut point in-vertex-first (getCutPoint( in, out )),
+  // and grid points are exact, so the same node always comes out with EXACTLY the same float bits,
+  // and welding is a hash lookup on those bits (no epsilons).
+  // Open addressing, linear probing.  weldTable holds node index+1 (0 is empty).
+  vector<int> weldTable ;
+
+  int numTets() const { return (int)tets.size()/4 ; }
+
+  void clear()
+  {
+    nodes.clear() ;
+    tets.clear() ;
+    neighbours.clear() ;
+    weldTable.clear() ;
+  }
+
+  inline static unsigned int hashPos( const Vector3f& p )
+  {
+    unsigned int b[3] ;
+    memcpy( b, p.elts, sizeof(b) ) ;
+    unsigned int h = ( b[0]*73856093u ) ^ ( b[1]*19349663u ) ^ ( b[2]*83492791u ) ;
+
+    // The low bits of a product only depend on the low bits of b, and a lot of floats
+    // (the grid points) have all-zero low mantissa bits, so mix the high bits down (murmur3's finalizer)
+    h ^= h >> 16 ;  h *= 0x85ebca6bu ;
+    h ^= h >> 13 ;  h *= 0xc2b2ae35u ;
+    h ^= h >> 16 ;
+    return h ;
+  }
+
+  inline static bool samePos( const Vector3f& a, const Vector3f& b )
+  {
+    return !memcmp( a.elts, b.elts, sizeof(a.elts) ) ;
+  }
+
+  // Gets the index of the node at p, adding it if it's new.
+  int node( const Vector3f& p )
+  {
+    // keep the load under 1/2
+    if( 2*( nodes.size()+1 ) > weldTable.size() )
+    {
+      vector<int> old ;
+      old.swap( weldTable ) ;
+      weldTable.resize( max( (size_t)1024, 2*old.size() ), 0 ) ;
+      for( int i = 0 ; i < nodes.size() ; i++ )
+      {
+        unsigned int h = hashPos( nodes[i] ) & ( weldTable.size()-1 ) ;
+        while( weldTable[h] )  h = ( h+1 ) & ( weldTable.size()-1 ) ;
+        weldTable[h] = i+1 ;
+      }
+    }
+
+    unsigned int h = hashPos( p ) & ( weldTable.size()-1 ) ;
+    while( weldTable[h] )
+    {
+      if( samePos( nodes[ weldTable[h]-1 ], p ) )
+        return weldTable[h]-1 ;
+      h = ( h+1 ) & ( weldTable.size()-1 ) ;
+    }
+    nodes.push_back( p ) ;
+    weldTable[h] = (int)nodes.size() ;
+    return (int)nodes.size()-1 ;
+  }
+
+  // Adds tet (a,b,c,d), fixing the winding so its volume is positive.
+  // Degenerate tets (a repeated node, from an isosurface passing exactly through a grid point)
+  // are left out.
+  void addTet( int a, int b, int c, int d )
+  {
+    if( a==b || a==c || a==d || b==c || b==d || c==d )  return ;
+    Vector3f &A = nodes[a] ;
+    if( ( nodes[b] - A ).cross( nodes[c] - A ).dot( nodes[d] - A ) < 0 )
+      swap( b, c ) ;
+    tets.push_back( a ) ;  tets.push_back( b ) ;  tets.push_back( c ) ;  tets.push_back( d ) ;
+  }
+
+  // Splits the prism with ends (v0,v1,v2) and (v3,v4,v5) (sides v0-v3, v1-v4, v2-v5) into 3 tets.
+  // Each quad side gets split along the diagonal through its lowest node index, so
+  // a neighbouring prism sharing that quad splits it the same way and the tets conform.
+  // (Dompierre et al, "How to subdivide pyramids, prisms and hexahedra into tetrahedra")
+  void addPrism( int v0, int v1, int v2, int v3, int v4, int v5 )
+  {
+    // rotate/flip the prism so the lowest index node is first
+    static const int rot[6][6] = {
+      { 0,1,2,3,4,5 }, { 1,2,0,4,5,3 }, { 2,0,1,5,3,4 },
+      { 3,5,4,0,2,1 }, { 4,3,5,1,0,2 }, { 5,4,3,2,1,0 }
+    } ;
+    int in[6] = { v0,v1,v2,v3,v4,v5 } ;
+    int lowest = (int)( min_element( in, in+6 ) - in ) ;
+    int v[6] ;
+    for( int i = 0 ; i < 6 ; i++ )
+      v[i] = in[ rot[lowest][i] ] ;
+
+    // The quads touching v[0] get split through it.  The one that doesn't (v1,v2,v5,v4)
+    // gets split through its own lowest node.
+    if( min( v[1], v[5] ) < min( v[2], v[4] ) )
+    {
+      addTet( v[0], v[1], v[2], v[5] ) ;
+      addTet( v[0], v[1], v[5], v[4] ) ;
+    }
+    else
+    {
+      addTet( v[0], v[1], v[2], v[4] ) ;
+      addTet( v[0], v[4], v[2], v[5] ) ;
+    }
+    addTet( v[0], v[4], v[5], v[3] ) ;
+  }
+
+  // Finds the tet across every face.  The 2 copies of an interior face have the same
+  // (sorted) nodes, so bucket the faces by their lowest node (a counting sort, every node
+  // only starts a handful of faces), then sort each little bucket to bring the copies together.
+  void buildNeighbours()
+  {
+    struct Face
+    {
+      int n1, n2 ;  // the face's other 2 nodes, sorted
+      int tetFace ; // tet*4 + face
+      bool operator<( const Face& o ) const {
+        return n1 != o.n1 ? n1 < o.n1 : n2 < o.n2 ;
+      }
+    } ;
+
+    // face f is every node of the tet but node f
+    vector<int> lowest( tets.size() ) ;
+    vector<int> bucketStart( nodes.size()+1, 0 ) ;
+    for( int tf = 0 ; tf < tets.size() ; tf++ )
+    {
+      const int* t = &tets[ tf & ~3 ] ;
+      int lo = -1 ;
+      for( int i = 0 ; i < 4 ; i++ )
+        if( i != (tf & 3) && ( lo == -1 || t[i] < lo ) )
+          lo = t[i] ;
+      lowest[tf] = lo ;
+      bucketStart[ lo+1 ]++ ;
+    }
+    for( int i = 0 ; i < nodes.size() ; i++ )
+      bucketStart[i+1] += bucketStart[i] ;
+
+    vector<Face> faces( tets.size() ) ;
+    vector<int> fill( bucketStart.begin(), bucketStart.end()-1 ) ;
+    for( int tf = 0 ; tf < tets.size() ; tf++ )
+    {
+      const int* t = &tets[ tf & ~3 ] ;
+      int other[2], j = 0 ;
+      for( int i = 0 ; i < 4 ; i++ )
+        if( i != (tf & 3) && t[i] != lowest[tf] )
+          other[j++] = t[i] ;
+      Face &face = faces[ fill[ lowest[tf] ]++ ] ;
+      face.n1 = min( other[0], other[1] ) ;
+      face.n2 = max( other[0], other[1] ) ;
+      face.tetFace = tf ;
+    }
+
+    neighbours.assign( tets.size(), -1 ) ;
+    for( int n = 0 ; n < nodes.size() ; n++ )
+    {
+      sort( faces.begin() + bucketStart[n], faces.begin() + bucketStart[n+1] ) ;
+      for( int i = bucketStart[n] ; i+1 < bucketStart[n+1] ; i++ )
+      {
+        if( faces[i].n1 == faces[i+1].n1 && faces[i].n2 == faces[i+1].n2 )
+        {
+          neighbours[ faces[i].tetFace ] = faces[i+1].tetFace / 4 ;
+          neighbours[ faces[i+1].tetFace ] = faces[i].tetFace / 4 ;
+          i++ ;
+        }
+      }
+    }
+  }
+
+  // VTK writes binary data big endian.
+  static void writeBigEndian( FILE* f, const void* data, int count )
+  {
+    vector<unsigned char> buf( (const unsigned char*)data, (const unsigned char*)data + 4*count ) ;
+    if( !isBigEndian() )
+      for( int i = 0 ; i < buf.size() ; i += 4 )
+      {
+        swap( buf[i], buf[i+3] ) ;
+        swap( buf[i+1], buf[i+2] ) ;
+      }
+    fwrite( &buf[0], 4, count, f ) ;
+  }
+
+  static bool isBigEndian()
+  {
+    unsigned int one = 1 ;
+    return !*(unsigned char*)&one ;
+  }
+
+  // VTK legacy format, binary UNSTRUCTURED_GRID of VTK_TETRA cells.
+  // (ParaView, VisIt, and most FEM tools read it.)
+  bool exportVTK( const char* filename )
+  {
+    FILE* f = fopen( filename, "wb" ) ;
+    if( !f )
+    {
+      printf( "Can't open '%s'\n", filename ) ;
+      return false ;
+    }
+
+    fprintf( f, "# vtk DataFile Version 3.0\n" ) ;
+    fprintf( f, "marching tets volume mesh\n" ) ;
+    fprintf( f, "BINARY\n" ) ;
+    fprintf( f, "DATASET UNSTRUCTURED_GRID\n" ) ;
+
+    fprintf( f, "POINTS %d float\n", (int)nodes.size() ) ;
+    if( nodes.size() )  writeBigEndian( f, &nodes[0], 3*(int)nodes.size() ) ;
+
+    // each cell is (# nodes, nodes...)
+    int n = numTets() ;
+    vector<int> cells( 5*n ) ;
+    for( int i = 0 ; i < n ; i++ )
+    {
+      cells[5*i] = 4 ;
+      for( int j = 0 ; j < 4 ; j++ )
+        cells[5*i + 1+j] = tets[4*i + j] ;
+    }
+    fprintf( f, "\nCELLS %d %d\n", n, 5*n ) ;
+    if( n )  writeBigEndian( f, &cells[0], 5*n ) ;
+
+    vector<int> types( n, 10 ) ; // 10 is VTK_TETRA
+    fprintf( f, "\nCELL_TYPES %d\n", n ) ;
+    if( n )  writeBigEndian( f, &types[0], n ) ;
+    fprintf( f, "\n" ) ;
+
+    fclose( f ) ;
+    return true ;
+  }
+
+  // Medit / Gmsh .mesh (ASCII, indices are 1-based)
+  bool exportMedit( const char* filename )
+  {
+    FILE* f = fopen( filename, "w" ) ;
+    if( !f )
+    {
+      printf( "Can't open '%s'\n", filename ) ;
+      return false ;
+    }
+
+    fprintf( f, "MeshVersionFormatted 2\nDimension 3\n\n" ) ;
+    fprintf( f, "Vertices\n%d\n", (int)nodes.size() ) ;
+    for( int i = 0 ; i < nodes.size() ; i++ )
+      fprintf( f, "%.9g %.9g %.9g 0\n", nodes[i].x, nodes[i].y, nodes[i].z ) ;
+
+    fprintf( f, "\nTetrahedra\n%d\n", numTets() ) ;
+    for( int i = 0 ; i < tets.size() ; i += 4 )
+      fprintf( f, "%d %d %d %d 0\n", tets[i]+1, tets[i+1]+1, tets[i+2]+1, tets[i+3]+1 ) ;
+
+    fprintf( f, "\nEnd\n" ) ;
+    fclose( f ) ;
+    return true ;
+  }
+} ;
+
+// Sink for MarchingTetsT<true, VolumeMeshSink>: the solid pieces go into a VolumeMesh
+// as welded tets, instead of into a vertex array as faces.
+struct VolumeMeshSink
+{
+  // the tets that are all inside the surface are part of the volume too
+  static const bool wholeTets = true ;
+
+  VolumeMesh *mesh ;
+
+  VolumeMeshSink( VolumeMesh* iMesh ) : mesh( iMesh ) { }
+
+  // the surface isn't part of the volume (it's the boundary faces, see VolumeMesh::neighbours)
+  void tri( const Vector3f&, const Vector3f&, const Vector3f&, const Vector4f& ) { }
+
+  void tet( const Vector3f& A, const Vector3f& B, const Vector3f& C, const Vector3f& D, const Vector4f& ) {
+    mesh->addTet( mesh->node( A ), mesh->node( B ), mesh->node( C ), mesh->node( D ) ) ;
+  }
+
+  // the sides of the prisms marching tets makes are A-D, B-F, C-E
+  void prism( const Vector3f& A, const Vector3f& B, const Vector3f& C,
+              const Vector3f& D, const Vector3f& E, const Vector3f& F, const Vector4f& ) {
+    mesh->addPrism( mesh->node( A ), mesh->node( B ), mesh->node( C ),
+                    mesh->node( D ), mesh->node( F ), mesh->node( E ) ) ;
+  }
+} ;
+
+#endif
@@ -1,210 +1,382 @@
-#ifndef VOXEL_H
-#define VOXEL_H
-
-#include "Vectorf.h"
-#include "perlin.h"
-
-// handling for VOlumetrix piXEL (where pixel was PIXture ELement)
-struct Voxel
-{
-  float v ;
-  Vector4f d ;
-  Vector4f color ;
-} ;
-
-struct VoxelGrid
-{
-  // the actual 3d grid of voxels, stored as a linear array.
-  // You're not supposed to write these directly without calling RESIZE.
-  // A more conservative programmer would mark them private.
-  //int cols, rows, slabs ; // I used to have 3 variables instead of the Vector3i dims:
-  // cols for x, rows for y, and slabs for z.
-  Vector3i dims ; // dims is used when you need cols,rows,slabs as an xyz Vector3i
-
-  // I let you access the voxel grid directly if you want to.
-  vector<Voxel> voxels ;
-
-  // These variables are about where the voxel grid meets the world.
-  // by default the voxel grid goes on positive indices in xyz,
-  // but you may want voxel (0,0,0) to be at (-10.5,-10.5,-10.5) of your rendered world.
-  // So, these are the world transformations to apply when rendering the voxel grid.
-  float worldSize ;
-
-  Vector3f offset ;     // the offset appliied to the voxel grid to center it in world space
-  Vector3f gridSizer ;  // blow up the visualization so it isn't too small
-
-  void defaults(){
-    dims=Vector3i(10);
-    worldSize=200;
-  }
-
-  VoxelGrid()
-  {
-    defaults() ;
-    resize() ;
-  }
-
-  VoxelGrid( int size )
-  {
-    defaults() ;
-    dims=Vector3i(size);
-    resize() ;
-  }
-
-  VoxelGrid( int iCols, int iRows, int iSlabs )
-  {
-    defaults() ;
-    dims = Vector3i( iCols, iRows, iSlabs ) ;
-    resize() ;
-  }
-
-  // Call when #cols,rows,slabs has changed.
-  void resize()
-  {
-    voxels.resize( dims.x*dims.y*dims.z ) ;
-
-    // recalculate the offset to center the voxel grid in the world
-    offset = -Vector3f(dims)/2.f ;
-
-    // gridSizer first normalizes cols/rows/slabs, then mults each by
-    // worldSize.
-    gridSizer = Vector3f(worldSize) / dims ;
-  }
-
-  inline float wallValue( int wallSide ) const
-  {
-    int negWall = wallSide%2 ; // 0 for PX, PY (+walls),
-    // 1 for negative walls
-
-    // -2*negWall+1 gives: +1 for P walls, -1 for N walls
-    // (0=>+1, 1=>-1)
-    return (-2*negWall+1)*worldSize/2.f ;
-  }
-
-  void increaseResolution( int by )
-  {
-    dims += by ;
-    resize();
-  }
-
-  void increaseWorldSize( float by )
-  {
-    worldSize += by ;
-    gridSizer = Vector3f(worldSize) / dims ;
-  }
-
-  // converts triple indexing into a linear index to use on voxels array.
-  inline int index( int i, int j, int k ) const
-  {
-    // These comments use the old mapping of dims.x==cols, dims.y==rows, dims.z==slabs.
-    // i:             col index=> directly to linear offset.
-    // j*cols:        row index=> j*cols elts / row. This value gives linear offset.
-    // k*cols*rows:  slab index=> cols*rows elts covered / slab. Advance this many in linear array to skip to slab #k.
-    return i + j*dims.x + k*dims.x*dims.y ;
-  }
-  inline int index( const Vector3i& idx ) const
-  {
-    return index( idx.x, idx.y, idx.z ) ;
-  }
-
-  inline Vector3i& wrappedIndex( Vector3i& idx ) const
-  {
-    // modulus negative number not positive in C, so 
-    // you have to first take it to the +side by adding (cols,rows,slabs),
-    // then modulus by those dims.
-    idx += dims ;
-    idx %= dims ;
-    return idx;
-  }
-
-  // just directly looks up into the voxels array.
-  // because the voxel grid WRAPS,
-  inline Voxel& operator()( int i, int j, int k ) {
-    return (*this)( Vector3i(i,j,k) ) ;
-  }
-
-  // You can use a Vector3i to index the voxel grid too
-  inline Voxel& operator()( Vector3i idx ) {
-    wrappedIndex( idx ) ;
-    return voxels[ index(idx.x,idx.y,idx.z) ] ;
-  }
-
-  inline Voxel& getVoxel( Vector3i idx ) {
-    return (*this)( idx ) ;
-  }
-
-  // Gets you the real world space point of
-  // a given voxel grid index (using offset&gridSizer).
-  Vector3f getP( const Vector3i& dex )
-  {
-    return ( offset + dex ) * gridSizer ;
-  }
-
-  // Gets you the 3-space isosurface cut point
-  Vector3f getCutPoint( float isosurface, const Vector3i& A, const Vector3i& B )
-  {
-    // Minor optimization comment: repeated calls to getVoxel() DO happen
-    // for the same exact grid point.  that's a couple of adds and multiplies
-    // just to do the lookup, its best to cache these values.
-    float vA = getVoxel( A ).v ; // REDUNDANT
-    float vB = getVoxel( B ).v ; // REDUNDANT
-  
-    // Get the `t` that represents "% of the way from vA to vB"
-    float tAB = unlerp( isosurface, vA, vB ) ;
-
-    // 0 means @ vA.  1 means @ vB.  Outside of this range means
-    // before vA or beyond vB (error).
-    if( !isBetween( tAB, 0.f, 1.f ) )
-    {
-      // This error should ONLY come up if you look for a voxel grid intersection
-      // between two vertices that are ON THE SAME SIDE OF THE ISOSURFACE.
-      // In general if you are checking correctly a call like this should NEVER HAPPEN,
-      // hence the detailed warning.
-      printf( "ERROR: CUT POINT FOR ISOSURFACE %f "
-        "NOT BETWEEN VOXEL GRID (%d,%d,%d)=%f AND (%d,%d,%d)=%f. "
-        "CHECK YOUR ALGORITHM. t=%f\n", isosurface,
-         A.x,A.y,A.z,vA,  B.x,B.y,B.z,vB, tAB ) ;
-      return 0 ;
-    }
-    Vector3f cutAB = Vector3f::lerp( tAB, getP(A), getP(B) ) ;
-    return cutAB ;
-  }
-
-  void genData( float w, int wPeriod )
-  {
-    resize() ; // ensure voxel grid is right size.
-
-    Vector4f d1, d2 ;
-    for( int i = 0 ; i < dims.x ; i++ )
-    {
-      for( int j = 0 ; j < dims.y ; j++ )
-      {
-        for( int k = 0 ; k < dims.z ; k++ )
-        {
-          int dex = index(i,j,k);
-          float fx=(float)i/dims.x, fy=(float)j/dims.y, fz=(float)k/dims.z ;
-        
-          //voxels[ dex ].v = Perlin::sdnoise( fx*f1, fy*f1, fz*f1, w, &d1.x, &d1.y, &d1.z, &d1.w ) ;
-          //voxels[ dex ].v += Perlin::sdnoise( fx*f2, fy*f2, fz*f2, w, &d2.x, &d2.y, &d2.z, &d2.w ) ;
-          //voxels[ dex ].d = d1 + d2 ;
-
-          voxels[ dex ].v = Perlin::pnoise( fx, fy, fz, w, 1,1,1, wPeriod ) ;
-
-          for( int i = 2 ; i <= 4 ; i *= 2 )
-            voxels[ dex ].v += Perlin::pnoise( fx*i, fy*i, fz*i, w, i,i,i, wPeriod ) ;
-
-          //voxels[ dex ].v = Perlin::noise( fx*f1, fy*f1, fz*f1, w ) -
-          //                  fabsf( Perlin::noise( fx*f2, fy*f2, fz*f2, 10*w ) ) ; //randFloat() ;
-          //voxels[ dex ].v = Perlin::noise( sin(fx), cos(fy), sin(fz), w ) ; //randFloat() ;
-        }
-      }
-    }
-  }
-
-
-
-
-} ;
-
-
+#ifndef VOXEL_H
+#define VOXEL_H
+
+#include "Vectorf.h"
+#include "perlin.h"
+#include "Parallel.h"
+
+// handling for VOlumetrix piXEL (where pixel was PIXture ELement)
+struct Voxel
+{
+  float v ;
+  Vector4f d ;
+  Vector4f color ;
+} ;
+
+struct VoxelGrid
+{
+  // the actual 3d grid of voxels, stored as a linear array.
+  // You're not supposed to write these directly without calling RESIZE.
+  // A more conservative programmer would mark them private.
+  //int cols, rows, slabs ; // I used to have 3 variables instead of the Vector3i dims:
+  // cols for x, rows for y, and slabs for z.
+  Vector3i dims ; // dims is used when you need cols,rows,slabs as an xyz Vector3i
+
+  // I let you access the voxel grid directly if you want to.
+  vector<Voxel> voxels ;
+
+  // These variables are about where the voxel grid meets the world.
+  // by default the voxel grid goes on positive indices in xyz,
+  // but you may want voxel (0,0,0) to be at (-10.5,-10.5,-10.5) of your rendered world.
+  // So, these are the world transformations to apply when rendering the voxel grid.
+  float worldSize ;
+
+  Vector3f offset ;     // the offset appliied to the voxel grid to center it in world space
+  Vector3f gridSizer ;  // blow up the visualization so it isn't too small
+
+  // The grid cut into BrickSize^3 cell bricks, with the min and max value
+  // over each brick's corners, so ray casts can skip bricks the isosurface can't be in.
+  // Rebuilt by genData (call buildBricks() yourself if you write the voxels any other way).
+  static const int BrickSize = 8 ;
+  Vector3i brickDims ;
+  vector<float> brickMin, brickMax ;
+
+  void defaults(){
+    dims=Vector3i(10);
+    worldSize=200;
+  }
+
+  VoxelGrid()
+  {
+    defaults() ;
+    resize() ;
+  }
+
+  VoxelGrid( int size )
+  {
+    defaults() ;
+    dims=Vector3i(size);
+    resize() ;
+  }
+
+  VoxelGrid( int iCols, int iRows, int iSlabs )
+  {
+    defaults() ;
+    dims = Vector3i( iCols, iRows, iSlabs ) ;
+    resize() ;
+  }
+
+  // Call when #cols,rows,slabs has changed.
+  void resize()
+  {
+    voxels.resize( dims.x*dims.y*dims.z ) ;
+    updateTransform() ;
+  }
+
+  // Just the world transformation part of resize().  Doesn't touch the voxels,
+  // so a grid that is only ever streamed (see SlabStream) never has to allocate them.
+  void updateTransform()
+  {
+    // recalculate the offset to center the voxel grid in the world
+    offset = -Vector3f(dims)/2.f ;
+
+    // gridSizer first normalizes cols/rows/slabs, then mults each by
+    // worldSize.
+    gridSizer = Vector3f(worldSize) / dims ;
+  }
+
+  inline float wallValue( int wallSide ) const
+  {
+    int negWall = wallSide%2 ; // 0 for PX, PY (+walls),
+    // 1 for negative walls
+
+    // -2*negWall+1 gives: +1 for P walls, -1 for N walls
+    // (0=>+1, 1=>-1)
+    return (-2*negWall+1)*worldSize/2.f ;
+  }
+
+  void increaseResolution( int by )
+  {
+    dims += by ;
+    resize();
+  }
+
+  void increaseWorldSize( float by )
+  {
+    worldSize += by ;
+    gridSizer = Vector3f(worldSize) / dims ;
+  }
+
+  // converts triple indexing into a linear index to use on voxels array.
+  inline int index( int i, int j, int k ) const
+  {
+    // These comments use the old mapping of dims.x==cols, dims.y==rows, dims.z==slabs.
+    // i:             col index=> directly to linear offset.
+    // j*cols:        row index=> j*cols elts / row. This value gives linear offset.
+    // k*cols*rows:  slab index=> cols*rows elts covered / slab. Advance this many in linear array to skip to slab #k.
+    return i + j*dims.x + k*dims.x*dims.y ;
+  }
+  inline int index( const Vector3i& idx ) const
+  {
+    return index( idx.x, idx.y, idx.z ) ;
+  }
+
+  inline Vector3i& wrappedIndex( Vector3i& idx ) const
+  {
+    // modulus negative number not positive in C, so 
+    // you have to first take it to the +side by adding (cols,rows,slabs),
+    // then modulus by those dims.
+    idx += dims ;
+    idx %= dims ;
+    return idx;
+  }
+
+  // just directly looks up into the voxels array.
+  // because the voxel grid WRAPS,
+  inline Voxel& operator()( int i, int j, int k ) {
+    return (*this)( Vector3i(i,j,k) ) ;
+  }
+
+  // You can use a Vector3i to index the voxel grid too
+  inline Voxel& operator()( Vector3i idx ) {
+    wrappedIndex( idx ) ;
+    return voxels[ index(idx.x,idx.y,idx.z) ] ;
+  }
+
+  inline Voxel& getVoxel( Vector3i idx ) {
+    return (*this)( idx ) ;
+  }
+
+  // Gets you the real world space point of
+  // a given voxel grid index (using offset&gridSizer).
+  Vector3f getP( const Vector3i& dex )
+  {
+    return ( offset + dex ) * gridSizer ;
+  }
+
+  // Gets you the 3-space isosurface cut point
+  Vector3f getCutPoint( float isosurface, const Vector3i& A, const Vector3i& B )
+  {
+    // Minor optimization comment: repeated calls to getVoxel() DO happen
+    // for the same exact grid point.  that's a couple of adds and multiplies
+    // just to do the lookup, its best to cache these values.
+    float vA = getVoxel( A ).v ; // REDUNDANT
+    float vB = getVoxel( B ).v ; // REDUNDANT
+  
+    // Get the `t` that represents "% of the way from vA to vB"
+    float tAB = unlerp( isosurface, vA, vB ) ;
+
+    // 0 means @ vA.  1 means @ vB.  Outside of this range means
+    // before vA or beyond vB (error).
+    if( !isBetween( tAB, 0.f, 1.f ) )
+    {
+      // This error should ONLY come up if you look for a voxel grid intersection
+      // between two vertices that are ON THE SAME SIDE OF THE ISOSURFACE.
+      // In general if you are checking correctly a call like this should NEVER HAPPEN,
+      // hence the detailed warning.
+      printf( "ERROR: CUT POINT FOR ISOSURFACE %f "
+        "NOT BETWEEN VOXEL GRID (%d,%d,%d)=%f AND (%d,%d,%d)=%f. "
+        "CHECK YOUR ALGORITHM. t=%f\n", isosurface,
+         A.x,A.y,A.z,vA,  B.x,B.y,B.z,vB, tAB ) ;
+      return 0 ;
+    }
+    Vector3f cutAB = Vector3f::lerp( tAB, getP(A), getP(B) ) ;
+    return cutAB ;
+  }
+
+  // The field value at voxel (i,j,k)
+  float genValue( int i, int j, int k, float w, int wPeriod ) const
+  {
+    float fx=(float)i/dims.x, fy=(float)j/dims.y, fz=(float)k/dims.z ;
+  
+    //Vector4f d1, d2 ;
+    //float v = Perlin::sdnoise( fx*f1, fy*f1, fz*f1, w, &d1.x, &d1.y, &d1.z, &d1.w ) ;
+    //v += Perlin::sdnoise( fx*f2, fy*f2, fz*f2, w, &d2.x, &d2.y, &d2.z, &d2.w ) ;
+    //voxels[ dex ].d = d1 + d2 ;
+
+    float v = Perlin::pnoise( fx, fy, fz, w, 1,1,1, wPeriod ) ;
+
+    for( int i = 2 ; i <= 4 ; i *= 2 )
+      v += Perlin::pnoise( fx*i, fy*i, fz*i, w, i,i,i, wPeriod ) ;
+
+    //v = Perlin::noise( fx*f1, fy*f1, fz*f1, w ) -
+    //    fabsf( Perlin::noise( fx*f2, fy*f2, fz*f2, 10*w ) ) ; //randFloat() ;
+    //v = Perlin::noise( sin(fx), cos(fy), sin(fz), w ) ; //randFloat() ;
+    return v ;
+  }
+
+  void genData( float w, int wPeriod )
+  {
+    resize() ; // ensure voxel grid is right size.
+
+    for( int i = 0 ; i < dims.x ; i++ )
+      for( int j = 0 ; j < dims.y ; j++ )
+        for( int k = 0 ; k < dims.z ; k++ )
+          voxels[ index(i,j,k) ].v = genValue( i,j,k, w, wPeriod ) ;
+
+    buildBricks() ;
+  }
+
+  // Generates just z-slab k of the field into slab (dims.x*dims.y floats,
+  // indexed like index(i,j,0)), without touching the voxels array.
+  void genSlab( int k, float* slab, float w, int wPeriod ) const
+  {
+    for( int j = 0 ; j < dims.y ; j++ )
+      for( int i = 0 ; i < dims.x ; i++ )
+        slab[ index(i,j,0) ] = genValue( i,j,k, w, wPeriod ) ;
+  }
+
+  // The value at grid point (i,j,k), wrapping like operator() does,
+  // for any i,j,k (not just one dims away from the grid).
+  inline float wrappedValue( int i, int j, int k ) const
+  {
+    i %= dims.x ;  if( i < 0 )  i += dims.x ;
+    j %= dims.y ;  if( j < 0 )  j += dims.y ;
+    k %= dims.z ;  if( k < 0 )  k += dims.z ;
+    return voxels[ index(i,j,k) ].v ;
+  }
+
+  // Trilinear value at g, in grid space (grid point (i,j,k) is at g=(i,j,k)).
+  float sampleGrid( const Vector3f& g ) const
+  {
+    int i = (int)floorf( g.x ), j = (int)floorf( g.y ), k = (int)floorf( g.z ) ;
+    float fx = g.x - i, fy = g.y - j, fz = g.z - k ;
+    float c00 = lerp( fx, wrappedValue( i,j,k ),     wrappedValue( i+1,j,k ) ) ;
+    float c10 = lerp( fx, wrappedValue( i,j+1,k ),   wrappedValue( i+1,j+1,k ) ) ;
+    float c01 = lerp( fx, wrappedValue( i,j,k+1 ),   wrappedValue( i+1,j,k+1 ) ) ;
+    float c11 = lerp( fx, wrappedValue( i,j+1,k+1 ), wrappedValue( i+1,j+1,k+1 ) ) ;
+    return lerp( fz, lerp( fy, c00, c10 ), lerp( fy, c01, c11 ) ) ;
+  }
+
+  // min/max of every brick, over the (BrickSize+1)^3 grid points at its cell corners.
+  // The last brick on an axis is short when dims isn't a multiple of BrickSize,
+  // and the far corners of the last brick wrap around to the first grid points.
+  void buildBricks()
+  {
+    brickDims = ( dims + (BrickSize-1) ) / BrickSize ;
+    int numBricks = brickDims.x*brickDims.y*brickDims.z ;
+    brickMin.resize( numBricks ) ;
+    brickMax.resize( numBricks ) ;
+    if( voxels.empty() )  return ;
+
+    parallelFor( numBricks, [&]( int b ) {
+      Vector3i lo( b % brickDims.x, ( b / brickDims.x ) % brickDims.y, b / ( brickDims.x*brickDims.y ) ) ;
+      lo *= BrickSize ;
+      Vector3i hi( min( lo.x+BrickSize, dims.x ), min( lo.y+BrickSize, dims.y ), min( lo.z+BrickSize, dims.z ) ) ;
+      float lowest = HUGE_VALF, highest = -HUGE_VALF ;
+      for( int k = lo.z ; k <= hi.z ; k++ )
+        for( int j = lo.y ; j <= hi.y ; j++ )
+          for( int i = lo.x ; i <= hi.x ; i++ )
+          {
+            float v = wrappedValue( i,j,k ) ;
+            lowest = min( lowest, v ) ;
+            highest = max( highest, v ) ;
+          }
+      brickMin[b] = lowest ;
+      brickMax[b] = highest ;
+    } ) ;
+  }
+
+  // First crossing of the isosurface along origin + t*dir, for 0 <= t <= maxT,
+  // in world space.  Returns t, or -1 if the ray doesn't hit.
+  // Walks the ray cell by cell (3D DDA), sampling the field where the ray enters and leaves
+  // each cell, and refines the crossing with unlerp, like getCutPoint does along an edge.
+  // Whole bricks that can't hold the isosurface are stepped over without sampling.
+  // The grid wraps, so a ray leaving one side comes back in the other.
+  float castRay( const Vector3f& origin, const Vector3f& dir, float isosurface, float maxT ) const
+  {
+    if( voxels.empty() || brickMin.empty() )  return -1.f ; // only streamed, nothing to hit
+
+    // into grid space, where cells are 1 on a side and cell (i,j,k) spans [i,i+1) etc.
+    Vector3f o = origin/gridSizer - offset ;
+    Vector3f d = dir/gridSizer ;
+
+    Vector3i cell, step ;
+    Vector3f tNext, tDelta ; // t at the next cell wall on each axis, and t between walls
+    for( int axis = 0 ; axis < 3 ; axis++ )
+    {
+      cell[axis] = (int)floorf( o.elts[axis] ) ;
+      if( d.elts[axis] > 0 )
+      {
+        step[axis] = 1 ;
+        tDelta.elts[axis] = 1.f / d.elts[axis] ;
+        tNext.elts[axis] = ( cell[axis] + 1 - o.elts[axis] ) * tDelta.elts[axis] ;
+      }
+      else if( d.elts[axis] < 0 )
+      {
+        step[axis] = -1 ;
+        tDelta.elts[axis] = -1.f / d.elts[axis] ;
+        tNext.elts[axis] = ( o.elts[axis] - cell[axis] ) * tDelta.elts[axis] ;
+      }
+      else
+      {
+        step[axis] = 0 ;
+        tDelta.elts[axis] = tNext.elts[axis] = HUGE_VALF ;
+      }
+    }
+
+    // steps the DDA into the next cell across the nearest wall, returning the t it crossed at
+    auto advance = [&]() {
+      int axis = tNext.x < tNext.y ? ( tNext.x < tNext.z ? 0 : 2 ) : ( tNext.y < tNext.z ? 1 : 2 ) ;
+      float tWall = tNext.elts[axis] ;
+      cell[axis] += step[axis] ;
+      tNext.elts[axis] += tDelta.elts[axis] ;
+      return tWall ;
+    } ;
+
+    float t = 0.f ;
+    float vIn = sampleGrid( o ) ;
+    bool inside = vIn < isosurface ;
+    while( t < maxT )
+    {
+      // which brick the cell wraps into, and where that brick starts and ends around this cell
+      Vector3i wrapped = cell ;
+      for( int axis = 0 ; axis < 3 ; axis++ )
+      {
+        wrapped[axis] %= dims[axis] ;
+        if( wrapped[axis] < 0 )  wrapped[axis] += dims[axis] ;
+      }
+      Vector3i brick = wrapped / BrickSize ;
+      int b = brick.x + brick.y*brickDims.x + brick.z*brickDims.x*brickDims.y ;
+      if( brickMax[b] < isosurface || brickMin[b] >= isosurface )
+      {
+        // everything in the brick is on the side we're already on: walk out of it without sampling
+        Vector3i lo = cell - ( wrapped - brick*BrickSize ) ;
+        Vector3i hi = lo ;
+        for( int axis = 0 ; axis < 3 ; axis++ )
+          hi[axis] += min( BrickSize, dims[axis] - brick[axis]*BrickSize ) ;
+        while( t < maxT &&
+               cell.x >= lo.x && cell.x < hi.x && cell.y >= lo.y && cell.y < hi.y && cell.z >= lo.z && cell.z < hi.z )
+          t = advance() ;
+        if( t >= maxT )  break ;
+        vIn = sampleGrid( o + d*t ) ;
+        skip ;
+      }
+
+      // sample where the ray leaves this cell
+      float tOut = min( min( tNext.x, tNext.y ), tNext.z ) ;
+      if( tOut > maxT )  tOut = maxT ;
+      float vOut = sampleGrid( o + d*tOut ) ;
+      if( ( vOut < isosurface ) != inside )
+        return t + unlerp( isosurface, vIn, vOut )*( tOut - t ) ;
+
+      vIn = vOut ;
+      if( tOut >= maxT )  break ;
+      t = advance() ;
+    }
+    return -1.f ;
+  }
+
+  // castRay for a whole batch of rays, spread over the worker threads.
+  // outT[i] is ray i's t (hit point origins[i] + outT[i]*dirs[i]), or -1 for a miss.
+  void castRays( const Vector3f* origins, const Vector3f* dirs, int numRays, float isosurface, float maxT, float* outT ) const
+  {
+    parallelFor( numRays, [&]( int i ) {
+      outT[i] = castRay( origins[i], dirs[i], isosurface, maxT ) ;
+    } ) ;
+  }
+
+} ;
+
+
 #endif
\ No newline at end of file
@@ -1,1242 +1,1757 @@
-/*
-
-  https://github.com/superwills/Ice-OSurface
-  version 1.0 July 2 2013 7:30p
-
-  Copyright (C) 2013 William Sherif
-
-  This software is provided 'as-is', without any express or implied
-  warranty.  In no event will the authors be held liable for any damages
-  arising from the use of this software.
-
-  Permission is granted to anyone to use this software for any purpose,
-  including commercial applications, and to alter it and redistribute it
-  freely, subject to the following restrictions:
-
-  1. The origin of this software must not be misrepresented; you must not
-     claim that you wrote the original software. If you use this software
-     in a product, an acknowledgment in the product documentation would be
-     appreciated but is not required.
-  2. Altered source versions must be plainly marked as such, and must not be
-     misrepresented as being the original software.
-  3. This notice may not be removed or altered from any source distribution.
-
-  William Sherif
-  will.sherif@gmail.com
-
-  This source code includes Stefan Gustavson's Perlin noise code (in Perlin.h)
-
-*/
-
-
-#ifdef _WIN32
-#include <stdlib.h> // MUST BE BEFORE GLUT ON WINDOWS
-#include <gl/glut.h>
-
-
-
-#else
-#include <GLUT/glut.h>
-#include <OpenGL/gl.h>
-#include <OpenGL/glu.h>
-#include <Carbon/Carbon.h>  // key input
-#endif
-#include "perlin.h"
-#include "GLUtil.h"
-#include "StdWilUtil.h"
-#include "Vectorf.h"
-#include "Geometry.h"
-#include "MarchingCommon.h"
-#include <vector>
-#include <set>
-#include <functional>
-using namespace std;
-
-#include "VoxelGrid.h"
-#include "Mesh.h"
-#include "PointCloud.h"
-#include "MarchingTets.h"
-#include "MarchingCubes.h"
-
-
-
-
-
-// window width and height
-float w=768.f, h=768.f ;
-float mouseX, mouseY,
-  wTerrain=2.59f, // the w to use for the terrain generation
-  wTexture=0.1f,   // texture w
-  isosurface=0.38f // the isosurface variable
-;
-// the repeat period for w.
-static int wTerrainPeriod=8, wTexturePeriod=8;
-
-// How many times you want the procedural texture to repeat around the world
-// too few repeats (with a low res texture) will look pixellated
-// too many repeats will make the periodicity really apparent
-int textureRepeats = 2 ;
-
-enum VizGenMode { VizGenCubes, VizGenTets, VizGenPts } ;
-const char* VizGenModeName[] = { "VizGenCubes", "VizGenTets", "VizGenPts" } ;
-int vizGenMode = VizGenCubes ;
-
-// RENDERING OPTIONS:
-float lineWidth=1.f;
-bool lightingOn=1, axisLinesOn=0, displayTextOn=0;
-bool showGradients=0 ; // not used since gradients not generated here
-
-bool repeats = 0 ;  // Show the world repeated (key 'r')
-Axis axis ;         // for moving around in space
-float speed=0.02f ; // (key 'g'): movement speed
-float minEdgeLength=0.1f ; // the minimum ALLOWED edge length before the edge gets removed.
-
-
-// My global voxel grid.
-VoxelGrid voxelGrid ;
-Mesh mesh ;
-
-vector<VertexPC> gradients ; // for showing isosurface gradients as given by the 
-// Perlin noise class version that HAS gradients for each point (not used actually in final code)
-vector<VertexPC> debugLines ;  // for showing surface normals etc.
-void addDebugLine( const Vector3f& v1, const Vector4f& c1, const Vector3f& v2, const Vector4f& c2 )
-{
-  debugLines.push_back( VertexPC( v1, c1 ) ) ;
-  debugLines.push_back( VertexPC( v2, c2 ) ) ;
-}
-
-
-
-
-
-
-
-
-
-
-
-void genVizFromVoxelData()
-{
-  // Generate the visualization
-  mesh.verts.clear() ;
-  mesh.indices.clear() ;
-  gradients.clear() ;
-  debugLines.clear() ;
-
-  mesh.renderMode = GL_TRIANGLES ;
-  // ISOSURFACE GENERATION!
-  if( vizGenMode == VizGenPts )
-  {
-    // GENERATE THE VISUALIZATION AS POINTS
-    PointCloud pc( &voxelGrid, &mesh.verts, isosurface, White ) ; 
-    if( !pc.useCubes ) mesh.renderMode = GL_POINTS ;
-    pc.genVizPunchthru() ;
-    mesh.vertexTexture( wTexture, wTexturePeriod, voxelGrid.worldSize, textureRepeats ) ;
-  }
-  else if( vizGenMode == VizGenTets )
-  {
-    MarchingTets mt( &voxelGrid, &mesh.verts, isosurface, White ) ;
-    mt.genVizMarchingTets() ;
-    mesh.vertexTexture( wTexture, wTexturePeriod, voxelGrid.worldSize, textureRepeats ) ;
-    mesh.smoothMesh( &voxelGrid, minEdgeLength ) ;
-  }
-  else
-  {
-    MarchingCubes mc( &voxelGrid, &mesh.verts, isosurface, White ) ;
-    mc.genVizMarchingCubes() ;
-    mesh.vertexTexture( wTexture, wTexturePeriod, voxelGrid.worldSize, textureRepeats ) ;
-    mesh.smoothMesh( &voxelGrid, minEdgeLength ) ;
-  }
-  
-  
-}
-
-void regen()
-{
-  voxelGrid.genData( wTerrain, wTerrainPeriod ) ;    
-  genVizFromVoxelData() ;
-}
-
-// Voronoi texture
-struct Site
-{
-  int row,col;
-  Vector2f pos ;
-  Site() : row(0),col(0),pos( 0, 0 ) {}
-  Site( int icol, int irow ) : col(icol),row(irow),pos( icol, irow ) {}
-  
-  inline int getIndex( int rows, int cols ) const { return row*cols + col ; }
-  
-  // I center 
-  Vector2f getWrappedPos( const Vector2f& worldSize, const Vector2f& v ) const
-  {
-    Vector2f offsetToCenter = worldSize/2.f - v ; // takes relativeToV to worldCenter, I may go OOB
-    Vector2f imagePos = pos + offsetToCenter ; // I may go OOB as I am offset by the same amt that makes `this` @ worldCenter
-    return imagePos.wrap( worldSize ) - offsetToCenter ; // wrap to fit in a world of worldSize (+ space world)
-  }
-  
-  float getEuclideanDistance( const Vector2f& worldSize, const Vector2f& v ) const
-  {
-    return distance1( getWrappedPos( worldSize, v ), v ) ;
-  }
-  float getEuclideanDistance2( const Vector2f& worldSize, const Vector2f& v ) const
-  {
-    return distance2( getWrappedPos( worldSize, v ), v ) ;
-  }
-  
-  float getManhattanDistance( const Vector2f& worldSize, const Vector2f& v ) const
-  {
-    return (getWrappedPos( worldSize, v ) - v).fabs().sum() ; //manhattan distance
-  }
-  
-  float getChebyshevChessDistance( const Vector2f& worldSize, const Vector2f& v ) const
-  {
-    return (getWrappedPos( worldSize, v ) - v).max() ;
-  }
-} ;
-
-/// Procedural textures
-struct Texture
-{
-  GLuint texId ;
-  int w,h ;
-  vector<float> vals ; // floating point noise values.
-  
-  // You could work with each color channel separately.
-  // You could map rgb COMPLETELY DIFFERENTLY __at each stage__,
-  // which means rgb would go in totally distinct directions.
-  //vector<Vector4f> colorVals ; // colorized noise values.
-  
-  function<Vector4f ( float val )> colorizationFunc ;
-  
-  Texture( int iw, int ih ) : w(iw), h(ih)
-  {
-    vals.resize( w*h, 0.f ) ;
-    //colorVals.resize( w*h, Vector4f(0,0,0,1) ) ;
-    
-    // The default colorization func is basically grayscale, full alpha
-    colorizationFunc = []( float val ) -> Vector4f {
-      return Vector4f( val,val,val,1.f ) ;
-    } ;
-    
-    clear() ;
-  }
-  
-  ~Texture() {}
-  
-  inline void bind() const {
-    glBindTexture( GL_TEXTURE_2D, texId ) ;  CHECK_GL ;
-  }
-  
-  // clear black, full alpha
-  Texture& clear() {
-    clear( 0 ) ;
-    return *this ;
-  }
-  
-  Texture& clear( float toVal )
-  {
-    for( int i = 0 ; i < w*h ; i++ )
-      vals[ i ] = toVal ;
-    return *this ;
-  }
-  
-  Texture& randomNoise()
-  {
-    for( int i = 0 ; i < h ; i++ ) {
-      for( int j = 0 ; j < w ; j++ ) {
-        int dex = i*w + j ;
-        vals[ dex ] = randFloat() ;
-      }
-    }
-    return *this ;
-  }
-  
-  Texture& checkerboard( int dimX, int dimY, float darkVal, float lightVal )
-  {
-    for( int i = 0 ; i < h ; i++ ) {
-      for( int j = 0 ; j < w ; j++ ) {
-        int dex = i*w + j ;
-        int iCell = i / dimY ;
-        int jCell = j / dimX ;
-        
-        if( iCell % 2 == jCell % 2 )
-          vals[ dex ] = darkVal ;
-        else
-          vals[ dex ] = lightVal ;
-      }
-    }
-    return *this ;
-  }
-  
-  Texture& perlin( int octaves, float octaveScaleFactor, int freqMult )
-  {
-    for( int i = 0 ; i < h ; i++ ) {
-    for( int j = 0 ; j < w ; j++ ) {
-      int dex = i*w + j ;
-      
-      // if the baseFreq is TOO LOW, start at a higher one
-      float x = (float)i/h ;
-      float y = (float)j/w ;
-      
-      float scale = 1.f ;
-      int period = 1 ;
-      
-      // add a few octaves of typical fractal noise
-      for( int i=0 ; i < octaves ; i++ )
-      {
-        vals[dex] += Perlin::pnoise( x, y, period, period ) * scale ;
-
-        // "speed up" x and y
-        x *= freqMult ;
-        y *= freqMult ;
-        scale *= octaveScaleFactor ;
-        
-        // The period of the noise has grown
-        period *= freqMult ;
-
-      }
-    }}
-    return *this ;
-  }
-  
-  // worley's voronoi noise
-  Texture& worley( const vector<Site> &sites )
-  {
-    Vector2f worldSize( h, w ) ;
-    
-    vector<float> distanceBuffer( w*h, 0.f ) ;
-      
-    float largestMinDist = 0.f ;
-    for( int i = 0 ; i < h ; i++ ) {
-      for( int j = 0 ; j < w ; j++ ) {
-        int dex = i*w + j ;
-        
-        // get the min dist to all 12 sites
-        float minDist = HUGE ;
-        Vector2f mePos(j,i);
-        for( int si = 0 ; si < sites.size() ; si++ )
-        {
-          float dist = sites[si].getEuclideanDistance2( worldSize, mePos ) ; //euclidean distance
-          //float dist = sites[si].getManhattanDistance( worldSize, mePos ) ;
-          //float dist = sites[si].getChebyshevChessDistance( worldSize, mePos ) ; //chebyshev (chessboard)
-          
-          if( dist < minDist )  minDist = dist ;
-        }
-        distanceBuffer[ dex ] = minDist ;
-        
-        // After deciding on the minDist for that pixel (to all sites),
-        // see if that was the greatest minDist so far (normalizer)
-        if( minDist > largestMinDist )  largestMinDist = minDist ;
-      }
-    }
-    
-    // COLOR & NORMALIZE
-    for( int i = 0 ; i < h ; i++ ) {
-      for( int j = 0 ; j < w ; j++ ) {
-        int dex = i*w + j ;
-        float s = distanceBuffer[dex] / largestMinDist ;
-        vals[dex] = s ;
-      }
-    }
-    
-    return *this ;
-  }
-  
-  // I DEFINE an 'octave' for worley is "farther distances" (still have yet to verify my terminology with the literature),
-  // the "first octave" are the distances to the CLOSEST sites
-  // "2nd octave" distances to 2nd closest. (I think they call these F1, F2 etc.)
-  // initialScale is the multiplier for the 1st octave.
-  // if octaveScaleFactor is > 1, then the high octaves weigh MORE AND MORE
-  Texture& worley( int numSites, float initialScale, float octaveScaleFactor, int octaves )
-  {
-    vector<Site> sites ; // indices of sites.
-    for( int i = 0 ; i < numSites ; i++ )
-      sites.push_back( Site( randInt( 0, h ), randInt( 0, w ) ) ) ;
-      
-    Vector2f worldSize( h, w ) ;
-    
-    // these store distances in order.
-    vector< vector<float> > distanceBuffer( w*h ) ;
-    
-    for( int i = 0 ; i < h ; i++ ) {
-      for( int j = 0 ; j < w ; j++ ) {
-        int dex = i*w + j ;
-        Vector2f mePos(j,i);
-        
-        // Get all the distances to all the sites.
-        for( int si = 0 ; si < sites.size() ; si++ )
-        {
-          float dist = sites[si].getEuclideanDistance( worldSize, mePos ) ; //euclidean distance
-          //float dist = sites[si].getManhattanDistance( worldSize, mePos ) ;
-          //float dist = sites[si].getChebyshevChessDistance( worldSize, mePos ) ; //chebyshev (chessboard)
-          // chebyshev makes a thatch pattern
-          
-          // find the spot
-          vector<float>::iterator iter = distanceBuffer[dex].begin() ;
-
-          //                                                                                          0.6599          
-          //                                                                                             ^
-          // advance iter until the one it points to exceeds `dist`: they go in ascending order ( 0.4532, 1.1235, 2.23525 )
-          while( iter != distanceBuffer[dex].end() && dist > *iter )  ++iter ;
-          
-          // goes BEFORE iter. (and when iter points to "1 past the end", it goes before that.)
-          distanceBuffer[dex].insert( iter, dist ) ;
-        }
-      }
-    }
-    
-    // NORMALIZE
-    // find the max for each octave
-    vector<float> maxes( octaves, 0.f ) ;
-    for( int i = 0 ; i < w*h ; i++ )
-    {
-      for( int oc = 0 ; oc < octaves ; oc++ )
-      {
-        // "octave 0" is just the closest distance.  here
-        // maxes[0] looks in ALL distanceBuffer[dex] for
-        // the LARGEST "CLOSEST" distance
-        if( maxes[oc] < distanceBuffer[i][oc] )
-          maxes[oc] = distanceBuffer[i][oc] ;
-      }
-    }
-    
-    for( int i = 0 ; i < w*h ; i++ )
-      for( int oc = 0 ; oc < octaves ; oc++ )
-        distanceBuffer[i][oc] /= maxes[oc] ; // normalize EACH OCTAVE
-    
-    float scale = initialScale ;
-    
-    /*
-    // Sum the octaves.
-    for( int oc = 0 ; oc < octaves ; oc++ )
-    {
-      for( int i = 0 ; i < h ; i++ ) {
-      for( int j = 0 ; j < w ; j++ ) {
-        int dex = i*w + j ;
-        
-        // Apply the normalization to each octave here
-        float s = scale * distanceBuffer[dex][oc] / maxes[oc] ;
-        vals[dex] = s ;
-      }}
-      
-      scale *= octaveScaleFactor ;
-    }
-    */
-    
-    // Sum the octaves.
-    for( int i = 0 ; i < h ; i++ ) {
-    for( int j = 0 ; j < w ; j++ ) {
-      int dex = i*w + j ;
-      
-      // Apply the normalization to each octave here
-      float s = distanceBuffer[dex][1] - distanceBuffer[dex][0] ;
-      vals[dex] = s ;
-    }}
-    
-    scale *= octaveScaleFactor ;
-    return *this ;
-  }
-  
-  Texture& operator*=( const Texture& o ) {
-    for( int i = 0 ; i < w*h ; i++ )
-      vals[i] *= o.vals[i] ;
-    return *this ;
-  }
-  
-  Texture& operator/=( const Texture& o ) {
-    for( int i = 0 ; i < w*h ; i++ )
-      vals[i] /= o.vals[i] ;
-    return *this ;
-  }
-  
-  Texture& operator+=( const Texture& o ) {
-    for( int i = 0 ; i < w*h ; i++ )
-      vals[i] += o.vals[i] ;
-    return *this ;
-  }
-  
-  // bias the whole texture by some float val.
-  // useful if you want the MINIMUM value to be some range
-  Texture& operator+=( float val ) {
-    for( int i = 0 ; i < w*h ; i++ )
-      vals[i] += val ;
-    return *this ;
-  }
-  
-  Texture& operator-=( const Texture& o ) {
-    for( int i = 0 ; i < w*h ; i++ )
-      vals[i] -= o.vals[i] ;
-    return *this ;
-  }
-  
-  // FORCES opaque (alpha=1)
-//  Texture& opaque( const Texture& o ) {
-//    for( int i = 0 ; i < w*h ; i++ )
-//      vals[i].a = 1.f ;
-//    return *this ;
-//  }
-  
-  // Finds max component and makes range 0->1 all values
-  Texture& renormalize()
-  {
-    float maxVal=0.f;
-    float minVal=HUGE ;
-    
-    for( int i = 0 ; i < w*h ; i++ ) {
-      if( vals[i] > maxVal )  maxVal = vals[i] ;
-      if( vals[i] < minVal )  minVal = vals[i] ;
-    }
-    
-    // BIAS if -ve
-    // -0.2, 0.0, 0.2 => 0, 0.2, 0.4
-    if( minVal < 0.f ){
-      for( int i = 0 ; i < w*h ; i++ )
-        vals[i] -= minVal ;
-        
-      maxVal -= minVal ;
-    }
-
-    if( maxVal > 0.f )
-      for( int i = 0 ; i < w*h ; i++ )
-        vals[i] /= maxVal ;
-        
-    return *this ;
-  }
-  
-  void createGL()
-  {
-    renormalize() ;
-    
-    vector<unsigned int> texels ;
-    texels.resize( w * h, 0 ) ;
-    
-    // The default is to get the rGBA int from each vector4f
-    for( int i = 0 ; i < w*h ; i++ )
-      texels[i] = colorizationFunc( vals[ i ] ).RGBAInt() ;
-    
-    glGenTextures( 1, &texId ) ;  CHECK_GL ;
-    glBindTexture( GL_TEXTURE_2D, texId ) ;  CHECK_GL ;
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);  CHECK_GL ;
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);  CHECK_GL ;
-    
-    // we do not want to wrap, this will cause incorrect shadows to be rendered
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT ) ;  CHECK_GL ; //GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT ) ;  CHECK_GL ;
-    
-    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, &texels[0] ) ;  CHECK_GL ;
-    glActiveTexture( GL_TEXTURE0 ) ;  CHECK_GL ;
-  }
-} ;
-
-
-
-
-
-
-
-
-
-
-
-// Generates the procedural `detail texture`
-void genTex( int w, int h )
-{
-  Texture t1( w, h ) ;
-  Texture t2( w, h ) ;
-  
-  // perlin( int octaves, float initialScale, float octaveScaleFactor, int freqMult )
-  t1.worley( 25, 0.34, 1.3, 2 ) ;
-  t1 += 0.5 ;
-  t1.renormalize() ;
-  
-  t2.perlin( 8, 0.5, 2.0 ) ;
-  t2.renormalize() ;
-  t1 *= t2 ;
-  
-  t1.createGL() ;
-}
-
-
-
-
-
-
-
-
-
-
-
-void init() // Called before main loop to set up the program
-{
-  //initDirections() ;
-  regen() ;
-  genTex( 1024, 1024 ) ;
-  
-  axis.pos = Vector3f( 0, 0, 350 ) ;
-  glClearColor( 0.1, 0.1, 0.1, 0.1 ) ;
-  glEnable( GL_COLOR_MATERIAL ) ;
-
-  //glPointSize(16.f);
-  //for( int i = 0 ; i < 3*1000 ; i++ )
-  //  mesh.verts.push_back( VertexPC( Vector3f::random(-1,1), Vector4f::random() ) ) ;
-  
-  glEnable( GL_BLEND ) ;
-  glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA ) ;
-}
-
-void exportOBJ( const char* filename )
-{
-  FILE* f = fopen( filename, "w" ) ;
-
-  fprintf( f, "# ICE-OSURFACE .obj file output\n" ) ;
-  fprintf( f, "# v//n\n" ) ;
-
-  // Usually it goes v, v, v, v, n, n, n, n
-  for( int i = 0 ; i < mesh.verts.size() ; i++ )
-  {
-    fprintf( f, "v %f %f %f\n", mesh.verts[i].pos.x, mesh.verts[i].pos.y, mesh.verts[i].pos.z ) ;
-    //fprintf( f, "vn %f %f %f\n", mesh.verts[i].normal.x, mesh.verts[i].normal.y, mesh.verts[i].normal.z ) ;
-
-    // PER-VERTEX color.  Not recognized by any other program, I made this up.
-    // obj uses MATERIALS which I avoid here.
-    ///fprintf( f, "c %f %f %f %f\n", mesh.verts[i].color.x, mesh.verts[i].color.y, mesh.verts[i].color.z, mesh.verts[i].color.w ) ;
-  }
-  
-  for( int i = 0 ; i < mesh.verts.size() ; i++ )
-    fprintf( f, "vn %f %f %f\n", mesh.verts[i].normal.x, mesh.verts[i].normal.y, mesh.verts[i].normal.z ) ;
-
-  for( int i = 0 ; i < mesh.indices.size() ; i+=3 )
-  {
-    // color is not specified here
-    // INDEXING IS 1-BASED, NOT 0-BASED
-    fprintf( f, "f %d//%d %d//%d %d//%d\n",
-      mesh.indices[i  ]+1, mesh.indices[i  ]+1, 
-      mesh.indices[i+1]+1, mesh.indices[i+1]+1,
-      mesh.indices[i+2]+1, mesh.indices[i+2]+1 ) ;
-  }
-
-  fclose( f ) ;
-
-  #ifdef _WIN32
-  system( "start ." ) ; // open the folder in windows explorer
-  #endif
-}
-
-#ifdef __APPLE__
-KeyMap keyStates ;
-
-bool IS_KEYDOWN( uint16_t vKey )
-{
-  // http://stackoverflow.com/questions/11466294/getting-keyboard-state-using-getkeys-function
-  uint8_t index = vKey / 32 ;
-  uint8_t shift = vKey % 32 ;
-  return keyStates[index].bigEndianValue & (1 << shift) ;
-}
-#endif
-
-void keys()
-{
-  #ifdef _WIN32
-  
-  // Windows makes this easy and nice..
-  #define IS_KEYDOWN( c ) (GetAsyncKeyState( c ) & 0x8000)
-  if( IS_KEYDOWN( 'W' ) )
-    axis.pos += axis.forward * speed ;
-  if( IS_KEYDOWN( 'S' ) )
-    axis.pos -= axis.forward * speed ;
-  if( IS_KEYDOWN( 'A' ) )
-    axis.pos -= axis.right * speed ;
-  if( IS_KEYDOWN( 'D' ) )
-    axis.pos += axis.right * speed ;
-  if( IS_KEYDOWN( 'Q' ) )
-    axis.roll( -speed/15 ) ;
-  if( IS_KEYDOWN( 'E' ) )
-    axis.roll( speed/15 ) ;
-
-  #elif defined __APPLE__
-  
-  GetKeys(keyStates) ;
-  if( IS_KEYDOWN( kVK_ANSI_W ) )
-    axis.pos += axis.forward * speed ;
-  if( IS_KEYDOWN( kVK_ANSI_S ) )
-    axis.pos -= axis.forward * speed ;
-  if( IS_KEYDOWN( kVK_ANSI_A ) )
-    axis.pos -= axis.right * speed ;
-  if( IS_KEYDOWN( kVK_ANSI_D ) )
-    axis.pos += axis.right * speed ;
-  if( IS_KEYDOWN( kVK_ANSI_Q ) )
-    axis.roll( -speed/15 ) ;
-  if( IS_KEYDOWN( kVK_ANSI_E ) )
-    axis.roll( speed/15 ) ;
-
-  
-  #endif
-  }
-
-
-void drawElements( int renderMode, vector<int> indices )
-{
-  if( repeats )
-  {
-    for( int i = -1 ; i <= 1 ; i++ )
-    {
-      for( int j = -1 ; j <= 1 ; j++ )
-      {
-        int k = 0 ; //for( int k = -1 ; k <= 1 ; k++ )
-        {
-          glPushMatrix();
-          glTranslatef( i*voxelGrid.worldSize, j*voxelGrid.worldSize, k*voxelGrid.worldSize ) ;
-          glDrawElements( renderMode, (int)indices.size(), GL_UNSIGNED_INT, &indices[0] ) ;
-          glPopMatrix();
-        }
-      }
-    }
-  }
-  else
-  {
-    // draw it once
-    glDrawElements( renderMode, (int)indices.size(), GL_UNSIGNED_INT, &indices[0] ) ;
-  }
-}
-
-void drawBoundArray( int renderMode, int size )
-{
-  if( repeats )
-  {
-    for( int i = -1 ; i <= 1 ; i++ )
-    {
-      for( int j = -1 ; j <= 1 ; j++ )
-      {
-        int k = 0 ; //for( int k = -1 ; k <= 1 ; k++ )
-        {
-          glPushMatrix();
-          glTranslatef( i*voxelGrid.worldSize, j*voxelGrid.worldSize, k*voxelGrid.worldSize ) ;
-          glDrawArrays( renderMode, 0, size ) ;
-          glPopMatrix();
-        }
-      }
-    }
-  }
-  else
-  {
-    // draw it once
-    glDrawArrays( renderMode, 0, size ) ;
-  }
-}
-
-void glutPuts( const char* str, Vector2f pos, const Vector4f& color )
-{
-  // convert x,y to canonical
-  pos.y = h-pos.y ; // invert y
-  float canX = 2*pos.x/w-1, canY=2*pos.y/h-1;
-
-  glRasterPos2f( canX, canY ) ;
-  glColor4fv( &color.x ) ;
-  do glutBitmapCharacter( GLUT_BITMAP_HELVETICA_18, *str ); while( *(++str) ) ;
-}
-
-int glGetPolygonMode()
-{
-  int pMode[2];
-  glGetIntegerv( GL_POLYGON_MODE, pMode ) ;
-  return pMode[0]; /// the 2nd number is front&back or w/e
-}
-
-void draw()
-{
-  keys() ;
-
-  //pw += 0.01f ;
-  //genVoxels() ;
-  glEnable( GL_DEPTH_TEST ) ;
-  glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT ) ;
-
-  //glEnable( GL_CULL_FACE ) ;
-  //glCullFace( GL_BACK ) ;
-
-  glViewport( 0, 0, w, h ) ;
-  glMatrixMode( GL_PROJECTION ) ;
-  glLoadIdentity();
-  //glOrtho( -5, 5, -5, 5, 5, -5 ) ;
-  gluPerspective( 45.0, 1.0, 0.5, 1000.0 ) ;
-  
-  glMatrixMode(GL_MODELVIEW);
-  
-  glLoadIdentity();
-  Matrix4f mat = axis.getViewingMatrix4f() ;
-  glMultMatrixf( &mat.m00 ) ;
-
-  //gluLookAt( 0, 0, sbd,   0, 0, 0,   0, 1, 0 ) ;
-  //glRotatef( my, 1, 0, 0 ) ;
-  //glRotatef( mx, 0, 1, 0 ) ;
-  
-  if( axisLinesOn )
-  {
-    drawAxisLines() ;
-  }
-  
-  // Lights.
-  if( lightingOn )
-  {
-    vector<Vector4f> lightPoses ;
-    float ld = voxelGrid.worldSize ;
-    lightPoses.push_back( Vector4f(  ld,  ld/2, ld, 1 ) ) ;
-    lightPoses.push_back( Vector4f(  ld,  ld,   ld, 1 ) ) ;
-    lightPoses.push_back( Vector4f(   0,  ld,    0, 1 ) ) ;
-    lightPoses.push_back( Vector4f( -ld,   0,    0, 1 ) ) ;
-
-    static float r = 0.f;
-    r += 0.0001f;
-  
-    glDisable( GL_LIGHTING ) ;
-  
-    float white[4] = {1,1,1,1};
-    for( int i = 0 ; i < lightPoses.size() ; i++ )
-    {
-      glEnable( GL_LIGHT0 + i ) ;
-      lightPoses[i].xyz() = Matrix3f::rotationY( r ) * lightPoses[i].xyz() ;
-      glLightfv( GL_LIGHT0 + i, GL_POSITION, &lightPoses[i].x ) ;
-      glLightfv( GL_LIGHT0 + i, GL_DIFFUSE, white ) ;
-      glLightfv( GL_LIGHT0 + i, GL_SPECULAR, white ) ;
-
-      // visualize the light
-      glPushMatrix();
-      glTranslatef( lightPoses[i].x, lightPoses[i].y, lightPoses[i].z ) ;
-      glutSolidSphere( voxelGrid.worldSize/10, 16, 16 ) ;
-      glPopMatrix() ;
-    }
-  
-    Vector4f spec( 1,1,1,50 ) ;
-    glMaterialfv( GL_FRONT_AND_BACK, GL_SPECULAR, &spec.x ) ;
-    glMaterialf( GL_FRONT_AND_BACK, GL_SHININESS, spec.w ) ;
-  
-    glEnable( GL_LIGHTING ) ;
-  }
-  
-  glEnableClientState( GL_VERTEX_ARRAY ) ;  CHECK_GL ;
-  glEnableClientState( GL_NORMAL_ARRAY ) ;  CHECK_GL ;
-  glEnableClientState( GL_COLOR_ARRAY ) ;  CHECK_GL ;
-  glEnableClientState( GL_TEXTURE_COORD_ARRAY ) ;  CHECK_GL ;
-  
-  // Bind a texture to use
-  glEnable( GL_TEXTURE_2D ) ;
-  
-  // DRAW THE MESH
-  if( mesh.verts.size() )
-  {
-    //glDepthMask( 0 ) ;
-    if( !mesh.indices.size() ) // NO INDEX BUFFER
-    {
-      // vertex arrays with no index buffer
-      glVertexPointer( 3, GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].pos ) ;
-      glNormalPointer( GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].normal ) ;
-      glColorPointer( 4, GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].color ) ;
-      glTexCoordPointer( 2, GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].tex ) ;
-      
-      if( repeats )
-      {
-        for( int i = -1 ; i <= 1 ; i++ )
-        {
-          for( int j = -1 ; j <= 1 ; j++ )
-          {
-            int k = 0 ; //for( int k = -1 ; k <= 1 ; k++ )
-            { 
-              glPushMatrix();
-              glTranslatef( i*voxelGrid.worldSize, j*voxelGrid.worldSize, k*voxelGrid.worldSize ) ;
-              glDrawArrays( mesh.renderMode, 0, (int)mesh.verts.size() ) ;
-              glPopMatrix();
-            }
-          }
-        }
-      }
-      else
-        glDrawArrays( mesh.renderMode, 0, (int)mesh.verts.size() ) ;
-    }
-    else
-    {
-      // Use the index buffer if it exists
-      glVertexPointer( 3, GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].pos ) ;
-      glNormalPointer( GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].normal ) ;
-      glColorPointer( 4, GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].color ) ;
-      glTexCoordPointer( 2, GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].tex ) ;
-      
-      drawElements( mesh.renderMode, mesh.indices ) ;
-    }
-    //glDepthMask( 1 ) ;
-  }
-  
-  glDisableClientState( GL_NORMAL_ARRAY ) ;  CHECK_GL ;
-  glDisableClientState( GL_TEXTURE_COORD_ARRAY ) ;  CHECK_GL ;
-  glDisable( GL_TEXTURE_2D ) ;
-  glDisable( GL_LIGHTING ) ;
-  
-  // Draw some debug lines etc.
-  if( showGradients )
-  {
-    glVertexPointer( 3, GL_FLOAT, sizeof( VertexPC ), &gradients[0].pos ) ;
-    glColorPointer( 4, GL_FLOAT, sizeof( VertexPC ), &gradients[0].color ) ;
-
-    drawBoundArray( GL_LINES, (int)gradients.size() ) ;
-  }
-  if( debugLines.size() )
-  {
-    glVertexPointer( 3, GL_FLOAT, sizeof( VertexPC ), &debugLines[0].pos ) ;
-    glColorPointer( 4, GL_FLOAT, sizeof( VertexPC ), &debugLines[0].color ) ;
-    
-    drawBoundArray( GL_LINES, (int)debugLines.size() ) ;
-  }
-  glDisableClientState( GL_VERTEX_ARRAY ) ;
-  glDisableClientState( GL_COLOR_ARRAY ) ;
-  
-
-  
-  //TEXT
-  glMatrixMode( GL_MODELVIEW ) ;
-  glLoadIdentity() ;
-  glMatrixMode( GL_PROJECTION ) ;
-  glLoadIdentity();
-  glDisable( GL_DEPTH_TEST ) ;
-  
-  // subwindow overlay
-  glEnable( GL_TEXTURE_2D ) ;
-  glEnableClientState( GL_VERTEX_ARRAY ) ;  CHECK_GL ;
-  glEnableClientState( GL_COLOR_ARRAY ) ;  CHECK_GL ;
-  glEnableClientState( GL_TEXTURE_COORD_ARRAY ) ;  CHECK_GL ;
-  
-  int swSize=180, swMargin=10;
-  glViewport( w - swSize-swMargin, swMargin, swSize, swSize ) ;
-  float m=2.f;
-  static VertexPCT subWindowQuad[6] = {
-    VertexPCT( Vector3f(-1,-1,0), 1, Vector2f(0,0) ),
-    VertexPCT( Vector3f(1,-1,0), 1, Vector2f(m,0) ),
-    VertexPCT( Vector3f(1,1,0), 1, Vector2f(m,m) ),
-    
-    VertexPCT( Vector3f(-1,-1,0), 1, Vector2f(0,0) ),
-    VertexPCT( Vector3f(1, 1, 0), 1, Vector2f(m,m) ),
-    VertexPCT( Vector3f(-1, 1, 0), 1, Vector2f(0,m) )
-  } ;
-  
-  glVertexPointer( 3, GL_FLOAT, sizeof( VertexPCT ), &subWindowQuad[0].pos ) ;
-  glColorPointer( 4, GL_FLOAT, sizeof( VertexPCT ), &subWindowQuad[0].color ) ;
-  glTexCoordPointer( 2, GL_FLOAT, sizeof( VertexPCT ), &subWindowQuad[0].tex ) ;
-  
-  glDrawArrays( GL_TRIANGLES, 0, 6 ) ;
-  
-  glDisableClientState( GL_VERTEX_ARRAY ) ;  CHECK_GL ;
-  glDisableClientState( GL_COLOR_ARRAY ) ;  CHECK_GL ;
-  glDisableClientState( GL_TEXTURE_COORD_ARRAY ) ;  CHECK_GL ;
-  glDisable( GL_TEXTURE_2D ) ;
-  
-  if( displayTextOn )
-  {
-    // back to full for text
-    glViewport( 0, 0, w, h ) ;
-    int polyMode ;
-    glGetIntegerv( GL_POLYGON_MODE, &polyMode ) ;
-    char buf[1024];
-    int pos = sprintf( buf, "(!)export " ) ;
-    pos += sprintf( buf+pos, " (2)%s", glGetPolygonMode()==GL_FILL?"wireframe":"solid" ) ;
-    
-    // if you are in pts mode, special set of options available to you
-    if( vizGenMode==VizGenPts )
-    {
-      if( PointCloud::useCubes )
-        pos += sprintf( buf+pos, " (3)render points (p/P)cubesize" ) ;
-      else
-        pos += sprintf( buf+pos, " (3)render cubes (p/P)ointsize" ) ;
-    }
-    pos += sprintf( buf+pos, repeats?" un(r)epeat":" (r)epeat" ) ;
-    
-    float yPos = 0.f, yi = 30.f ;
-    glutPuts( buf, Vector2f( 20, yPos+=yi ), White ) ;
-
-    int numPts = (int)mesh.verts.size() ;
-    const char* ptsOrTris = "pts" ;
-    if( mesh.renderMode==GL_TRIANGLES )
-    {
-      if( mesh.indices.size() )
-        numPts = (int)mesh.indices.size()/3 ;
-      else
-        numPts /= 3 ;
-      ptsOrTris = "tris" ;
-    }
-    else
-    {
-      
-    }
-    
-    sprintf( buf, "(t) %s (k)gridSize=%d / %s=%d (+/-)w=%.2f (i/I)isosurface=%.2f",
-      VizGenModeName[ vizGenMode ],
-      voxelGrid.dims.x, ptsOrTris, numPts,
-      wTerrain, isosurface ) ;
-    glutPuts( buf, Vector2f(20, yPos+=yi), White ) ;
-    sprintf( buf, "(n/N)minEdgeLength=%.3f (g/G)speed=%.2f (j/J)worldSize=%.2f",
-      minEdgeLength, speed, voxelGrid.worldSize ) ;
-    
-    glutPuts( buf, Vector2f(20, h-yi), White ) ;
-  }
-  
-  glutSwapBuffers();
-}
-
-// Called every time a window is resized to resize the projection matrix
-void resizeWindow( int newWidth, int newHeight )
-{
-  w = newWidth ;
-  h = newHeight ;
-}
-
-static int lastX=0, lastY=0 ;
-static int mmode=0;
-void mouseMotion( int x, int y )
-{
-  int dx = x-lastX, dy=y-lastY ;
-  
-  // LMB
-  if( mmode == GLUT_LEFT_BUTTON )
-  {
-    mouseX += dx, mouseY += dy ;
-    axis.yaw( 0.01f*dx ) ;
-    axis.pitch( 0.01f*dy ) ;
-  }
-  else if( mmode == GLUT_RIGHT_BUTTON )
-  {
-  }
-  
-  lastX=x,lastY=y;
-}
-
-void mouse( int button, int state, int x, int y )
-{
-  lastX = x ;
-  lastY = y ;
-  
-  mmode=button; // 0 for LMB, 2 for RMB
-  //printf( "%d %d %d %d\n", button,state,x,y ) ;
-}
-
-void keyboard( unsigned char key, int x, int y )
-{
-  float diff = 0.01f ;
-  
-  switch( key )
-  {
-  case '!':
-    exportOBJ( "exported.obj" ) ;
-    break ;
-
-  case '2':
-    {
-    int polyMode = glGetPolygonMode() ;
-    if( polyMode == GL_FILL )  glPolygonMode( GL_FRONT_AND_BACK, GL_LINE ) ;
-    else  glPolygonMode( GL_FRONT_AND_BACK, GL_FILL ) ;
-    }
-    break ;
-
-  case '3':
-    if( vizGenMode == VizGenPts )
-    {
-      PointCloud::useCubes = !PointCloud::useCubes ;
-      genVizFromVoxelData() ;
-    }
-    break ;
-    
-  case '4':
-    EPS += 1e-2f ;
-    regen() ;
-    break;
-  case '$':
-    EPS -= 1e-2f ;
-    regen() ;
-    break ;
-    
-  case '5':
-    displayTextOn = !displayTextOn ;
-    break ;
-
-  case '7':
-    axisLinesOn = !axisLinesOn ;
-    break ;
-    
-  case '=':
-    wTerrain+=diff;
-    regen();
-    break;
-  
-  case '+':
-    wTerrain+=10*diff;
-    regen() ;
-    break;
-  
-  case '-':
-    wTerrain-=diff;
-    regen();
-    break; 
-  
-  case '_':
-    wTerrain-=10*diff;
-    regen();
-    break;
-
-  case 'i':
-    isosurface += 0.01f ;
-    regen();
-    break ;
-
-  case 'I':
-    isosurface -= 0.01f ;
-    regen();
-    break ;
-
-  case 'c':
-    debugLines.clear() ;
-    break ;
-
-  case 'g':
-    speed += 0.01f;
-    break ;
-  case 'G':
-    speed -= 0.01f;
-    break; 
-  case 'h':
-    showGradients = !showGradients ;
-    break ;
-
-  case 'j':
-    voxelGrid.increaseWorldSize( 10 ) ;
-    regen() ;
-    break;
-
-  case 'J':
-    voxelGrid.increaseWorldSize( -10 ) ;
-    regen() ;
-    break; 
-
-  // refine the grid
-  case 'k':
-    voxelGrid.increaseResolution( 1 ) ;
-    regen() ;
-    break ;
-
-  case 'K':
-    voxelGrid.increaseResolution( -1 ) ;
-    regen() ;
-    break ;
-
-  case 'l':
-    lineWidth++;
-    clamp( lineWidth, 1.f, 16.f ) ;
-    glLineWidth( lineWidth ) ;
-    break; 
-  case 'L':
-    lineWidth--;
-    clamp( lineWidth, 1.f, 16.f ) ;
-    glLineWidth( lineWidth ) ;
-    break;
-    
-  case 'n':
-    minEdgeLength += 0.1 ;
-    regen() ;
-    break ;
-  case 'N':
-    minEdgeLength -= 0.1 ;
-    regen() ;
-    break ;
-  case 'm':
-    for( int i = 0 ;  i < mesh.verts.size() ; i++ )
-      addDebugLine( mesh.verts[i].pos, Black, mesh.verts[i].pos+mesh.verts[i].normal*1, mesh.verts[i].color ) ;
-    break; 
-
-  case 'p':
-    if( PointCloud::useCubes )
-    {
-      PointCloud::cubeSize += 1 ;
-      genVizFromVoxelData() ;
-    }
-    else
-    {
-      PointCloud::ptSize++;
-      ::clamp( PointCloud::ptSize, 1, 16 ) ;
-      glPointSize( PointCloud::ptSize ) ;
-    } 
-    break ;
-  case 'P':
-    if( PointCloud::useCubes )
-    {
-      PointCloud::cubeSize -= 1 ;
-      genVizFromVoxelData() ;
-    }
-    else
-    {
-      PointCloud::ptSize--;
-      ::clamp( PointCloud::ptSize, 1, 16 ) ;
-      glPointSize( PointCloud::ptSize ) ;
-    }
-    break ;
-  case 'r': repeats = !repeats ; break ;
-  case 't':
-    cycleFlag( vizGenMode, VizGenMode::VizGenCubes, VizGenMode::VizGenPts ) ;
-    regen() ;
-    break; 
-  case 'T':
-    decycleFlag( vizGenMode, VizGenMode::VizGenCubes, VizGenMode::VizGenPts ) ;
-    regen() ;
-    break; 
-
-  case 'y':
-    wTexture += 0.01f ;
-    mesh.vertexTexture( wTexture, wTexturePeriod, voxelGrid.worldSize, textureRepeats ) ;
-    break ;
-
-  case 'Y':
-    wTexture -= 0.01f ;
-    mesh.vertexTexture( wTexture, wTexturePeriod, voxelGrid.worldSize, textureRepeats ) ;
-    break ;
-
-  case 'z':
-    lightingOn=!lightingOn ;
-    break ;
-  case 27:
-    exit(0);
-    break;
-    
-  default:
-    break;
-  }
-}
-
-int main( int argc, char **argv )
-{
-  glutInit( &argc, argv ) ; // Initializes glut
-
-  glutInitDisplayMode( GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGBA ) ;
-  glutInitWindowSize( w, h ) ;
-  glutInitWindowPosition( 0, 0 ) ;
-  glutCreateWindow( "Isosurface contour from 3D Perlin noise" ) ;
-  glutReshapeFunc( resizeWindow ) ;
-  glutDisplayFunc( draw ) ;
-  glutIdleFunc( draw ) ;
-  
-  glutMotionFunc( mouseMotion ) ;
-  glutMouseFunc( mouse ) ;
-  
-  glutKeyboardFunc( keyboard ) ;
-
-  init();
-
-  glutMainLoop();
-  return 0;
-}
-
-
-
-
-
-
-
-
-
-
-
-
+/*
+
+  https://github.com/superwills/Ice-OSurface
+  version 1.0 July 2 2013 7:30p
+
+  Copyright (C) 2013 William Sherif
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  William Sherif
+  will.sherif@gmail.com
+
+  This source code includes Stefan Gustavson's Perlin noise code (in Perlin.h)
+
+*/
+
+
+#ifdef _WIN32
+#include <stdlib.h> // MUST BE BEFORE GLUT ON WINDOWS
+#include <gl/glut.h>
+
+
+
+#else
+#include <GLUT/glut.h>
+#include <OpenGL/gl.h>
+#include <OpenGL/glu.h>
+#include <Carbon/Carbon.h>  // key input
+#endif
+#include "perlin.h"
+#include "GLUtil.h"
+#include "StdWilUtil.h"
+#include "Vectorf.h"
+#include "Geometry.h"
+#include "MarchingCommon.h"
+#include <vector>
+#include <set>
+#include <functional>
+using namespace std;
+
+#include "VoxelGrid.h"
+#include "Mesh.h"
+#include "PointCloud.h"
+#include "MarchingTets.h"
+#include "MarchingCubes.h"
+#include "LODExtractor.h"
+#include "SurfaceNets.h"
+#include "SlabStream.h"
+#include "VolumeMesh.h"
+#include "PointReconstruction.h"
+#include "ProgressiveMesh.h"
+#include "MeshOptimizer.h"
+#include "TaubinSmoother.h"
+#include "PackedMesh.h"
+#include "AllocationCount.h"
+
+
+
+
+
+// window width and height
+float w=768.f, h=768.f ;
+float mouseX, mouseY,
+  wTerrain=2.59f, // the w to use for the terrain generation
+  wTexture=0.1f,   // texture w
+  isosurface=0.38f // the isosurface variable
+;
+// the repeat period for w.
+static int wTerrainPeriod=8, wTexturePeriod=8;
+
+// How many times you want the procedural texture to repeat around the world
+// too few repeats (with a low res texture) will look pixellated
+// too many repeats will make the periodicity really apparent
+int textureRepeats = 2 ;
+
+enum VizGenMode { VizGenCubes, VizGenTets, VizGenPts, VizGenLOD, VizGenNets } ;
+const char* VizGenModeName[] = { "VizGenCubes", "VizGenTets", "VizGenPts", "VizGenLOD", "VizGenNets" } ;
+int vizGenMode = VizGenCubes ;
+bool streamSlabs = 0 ; // (key '8' in cubes mode): generate+march the field a z-slab at a time
+bool dualContour = 0 ; // (key '3' in nets mode): QEF vertex placement instead of mass point
+bool reconstructPts = 0 ; // (key '9' in pts mode): mesh the points with PointReconstruction, as if they were scanned
+bool ptsWithoutNormals = 0 ; // (key '0' when reconstructing): the points come bare, like most scanners', and get estimated normals
+
+// RENDERING OPTIONS:
+float lineWidth=1.f;
+bool lightingOn=1, axisLinesOn=0, displayTextOn=0;
+bool showGradients=0 ; // not used since gradients not generated here
+
+bool repeats = 0 ;  // Show the world repeated (key 'r')
+Axis axis ;         // for moving around in space
+float speed=0.02f ; // (key 'g'): movement speed
+float minEdgeLength=0.1f ; // the minimum ALLOWED edge length before the edge gets removed.
+int taubinPasses=0 ; // (u/U): lambda|mu smoothing passes, after smoothMesh's edge collapses
+float decimateKeep=1.f ; // (v/V): the fraction of the triangles the progressive mesh's level keeps (1 is full res)
+bool packedVerts = 0 ; // (key '6'): draw and export triangle meshes from 20 byte VertexPacked verts
+int meshAttribs = 0 ; // the VertexAttribs mesh's verts (and the progressive mesh's) have filled in, see needAttribs
+
+
+// My global voxel grid.
+VoxelGrid voxelGrid ;
+Mesh mesh ;
+PackedMesh packedMesh ; // mesh, packed, when packedVerts is on
+ProgressiveMesh progressive ; // mesh's collapses, once decimateKeep goes under 1
+int packedLevel = -1 ; // the level of progressive packedMesh has, or -1 when it has mesh
+TaubinSmoother smoother( &mesh, &voxelGrid ) ; // kept, so its buffers are reused from regen to regen
+
+vector<VertexPC> gradients ; // for showing isosurface gradients as given by the 
+// Perlin noise class version that HAS gradients for each point (not used actually in final code)
+vector<VertexPC> debugLines ;  // for showing surface normals etc.
+void addDebugLine( const Vector3f& v1, const Vector4f& c1, const Vector3f& v2, const Vector4f& c2 )
+{
+  debugLines.push_back( VertexPC( v1, c1 ) ) ;
+  debugLines.push_back( VertexPC( v2, c2 ) ) ;
+}
+
+
+
+
+
+
+
+
+
+
+
+// Once decimateKeep goes under 1, what's drawn and exported is the progressive mesh's level,
+// straight from its arrays (its verts, and the first 3*liveTris of its indices), otherwise mesh.
+bool lodShown()
+{
+  return decimateKeep < 1.f && progressive.collapses.size() ;
+}
+
+const vector<VertexPNCT>& shownVerts()
+{
+  return lodShown() ? progressive.verts : mesh.verts ;
+}
+
+const vector<int>& shownIndices()
+{
+  return lodShown() ? progressive.indices : mesh.indices ;
+}
+
+int shownNumIndices()
+{
+  return lodShown() ? 3*progressive.liveTris : (int)mesh.indices.size() ;
+}
+
+// Packs what's shown into packedMesh when packedVerts is on (and it's indexed triangles),
+// in the voxel grid's bounds.  Otherwise packedMesh is emptied and mesh draws as it is.
+void packMesh()
+{
+  // (cleared, not reset, so the packed arrays keep their memory)
+  packedMesh.verts.clear() ;
+  packedMesh.indices.clear() ;
+  packedMesh.numIndices = 0 ;
+  packedLevel = -1 ;
+  if( packedVerts && mesh.renderMode == GL_TRIANGLES && mesh.indices.size() )
+  {
+    packedMesh.pack( shownVerts(), shownIndices(), shownNumIndices(),
+      Vector3f( -voxelGrid.worldSize/2 ), Vector3f( voxelGrid.worldSize/2 ) ) ;
+    if( lodShown() )
+      packedLevel = progressive.level ;
+  }
+}
+
+// (v/V): goes to the level of the progressive mesh with decimateKeep of the triangles.
+// The collapses are recorded from mesh (already in the vertex cache order) the first time,
+// and after that changing levels only replays (or undoes) the collapses in between,
+// nothing is regenerated or reordered.  The packed copy follows the same way, only what
+// the collapses changed is copied and repacked; it's all packed again only when what's
+// shown goes from mesh to a level or back.
+void selectLOD()
+{
+  if( progressive.collapses.empty() )
+  {
+    if( decimateKeep >= 1.f )
+      return ; // mesh is already full res (and packed)
+    if( mesh.renderMode != GL_TRIANGLES || mesh.indices.empty() )
+    {
+      packMesh() ; // can't be decimated, so it's mesh that's shown
+      return ;
+    }
+    progressive.build( mesh, &voxelGrid ) ;
+  }
+  progressive.setTriangleCount( (int)( decimateKeep*progressive.fullTris() ) ) ;
+  if( packedLevel >= 0 && lodShown() )
+  {
+    progressive.forChangedSince( packedLevel,
+      [&]( int slot ) { packedMesh.indices[ slot ] = progressive.indices[ slot ] ; },
+      [&]( int v ) { packedMesh.packVertex( v, progressive.verts[ v ] ) ; } ) ;
+    packedMesh.numIndices = 3*progressive.liveTris ;
+    packedLevel = progressive.level ;
+  }
+  else
+    packMesh() ;
+}
+
+// The sinks ask for the vertex attributes they read before they read mesh: drawing and
+// the packed .ply export want them all, the .obj export and the point cloud .ply none.
+// Only the missing ones are filled in, once a regen (or again when y/Y change the colors).
+// They're worked out from mesh's full res positions, and the progressive mesh has the
+// same verts (only moved), so when it's built it just gets a copy of them.
+// The color pass is skipped when the mesh has the debug colors on.
+void needAttribs( int attribs )
+{
+  if( mesh.debugColors() )
+    meshAttribs |= AttribColor ;
+  int missing = attribs & ~meshAttribs ;
+  if( !missing )  return ;
+  meshAttribs |= missing ;
+
+  mesh.vertexTexture( wTexture, wTexturePeriod, voxelGrid.worldSize, textureRepeats, missing ) ;
+  for( int i = 0 ; i < progressive.verts.size() ; i++ )
+  {
+    progressive.verts[i].color = mesh.verts[i].color ;
+    progressive.verts[i].tex = mesh.verts[i].tex ;
+  }
+  packMesh() ;
+}
+
+void genVizFromVoxelData()
+{
+  // Generate the visualization
+  mesh.verts.clear() ;
+  mesh.indices.clear() ;
+  mesh.indicesChanged() ; // (and the extractors that write indices through a pointer say so again below)
+  meshAttribs = 0 ; // (the sinks fill in what they need, see needAttribs)
+  gradients.clear() ;
+  debugLines.clear() ;
+
+  mesh.renderMode = GL_TRIANGLES ;
+  // ISOSURFACE GENERATION!
+  if( vizGenMode == VizGenPts )
+  {
+    // GENERATE THE VISUALIZATION AS POINTS
+    // 1 vertex per point, even with useCubes on (the cubes are expanded at draw time)
+    PointCloud pc( &voxelGrid, &mesh.verts, isosurface, White ) ; 
+    if( reconstructPts )
+    {
+      // Mesh the points without using the field or the grid, just the points and their normals
+      vector<Vector3f> pts, normals ;
+      pc.genHitPoints( pts, normals ) ;
+      float gridStep = max( voxelGrid.gridSizer.x, max( voxelGrid.gridSizer.y, voxelGrid.gridSizer.z ) ) ;
+      // without the field's normals: from each point's neighbours (out to the reconstruction's
+      // neighbour distance), which side they end up on per patch is arbitrary
+      if( ptsWithoutNormals )
+        PointReconstruction::estimateNormals( pts, 3.f*gridStep, 16, normals ) ;
+      PointReconstruction pr( &pts, &normals, 1.5f*gridStep ) ;
+      pr.reconstruct( mesh.indices ) ;
+      mesh.indicesChanged() ;
+      for( int i = 0 ; i < pts.size() ; i++ )
+        mesh.verts.push_back( VertexPNCT( pts[i], normals[i], White ) ) ;
+    }
+    else
+    {
+      mesh.renderMode = GL_POINTS ;
+      pc.genVizPunchthru() ;
+    }
+  }
+  else if( vizGenMode == VizGenNets )
+  {
+    // writes an indexed mesh directly, so there's no smoothMesh pass
+    SurfaceNets sn( &voxelGrid, &mesh.verts, &mesh.indices, isosurface, White ) ;
+    sn.dualContour = dualContour ;
+    sn.genVizSurfaceNets() ;
+    mesh.indicesChanged() ;
+  }
+  else if( vizGenMode == VizGenLOD )
+  {
+    // biggest power of 2 chunk (up to 16 cells) that divides the grid
+    int chunkSize = 16 ;
+    while( chunkSize > 1 && ( voxelGrid.dims.x % chunkSize || voxelGrid.dims.y % chunkSize || voxelGrid.dims.z % chunkSize ) )
+      chunkSize /= 2 ;
+    LODExtractor lod( &voxelGrid, &mesh.verts, isosurface, White, chunkSize, 4 ) ;
+    lod.selectLevels( axis.pos, voxelGrid.worldSize/2 ) ; // full res out to half a world away
+    lod.genVizLOD() ;
+    mesh.smoothMesh( &voxelGrid, minEdgeLength ) ;
+  }
+  else if( vizGenMode == VizGenTets )
+  {
+    MarchingTets mt( &voxelGrid, &mesh.verts, isosurface, White ) ;
+    mt.genVizMarchingTets( mesh.indices ) ;
+    mesh.indicesChanged() ;
+    mesh.smoothMesh( &voxelGrid, minEdgeLength ) ;
+  }
+  else if( streamSlabs )
+  {
+    // The field is generated slab by slab as it's marched, so the voxels are never filled.
+    vector<Voxel>().swap( voxelGrid.voxels ) ;
+    voxelGrid.updateTransform() ;
+    MarchingCubes mc( &voxelGrid, &mesh.verts, isosurface, White ) ;
+    SlabStream stream( &voxelGrid, wTerrain, wTerrainPeriod ) ;
+    stream.run( mc, []( int k, vector<VertexPNCT>& layerVerts ) {
+      mesh.verts.insert( mesh.verts.end(), layerVerts.begin(), layerVerts.end() ) ;
+    } ) ;
+    mesh.smoothMesh( &voxelGrid, minEdgeLength ) ;
+  }
+  else
+  {
+    MarchingCubes mc( &voxelGrid, &mesh.verts, isosurface, White ) ;
+    mc.genVizMarchingCubes() ;
+    mesh.smoothMesh( &voxelGrid, minEdgeLength ) ;
+  }
+  
+  if( taubinPasses && mesh.renderMode == GL_TRIANGLES && mesh.indices.size() )
+    smoother.smooth( taubinPasses ) ;
+
+  // last, so both drawing and the exports get the GPU friendly order
+  // (and so does the progressive mesh, its triangles keep it within each death step)
+  if( mesh.renderMode == GL_TRIANGLES && mesh.indices.size() )
+    optimizeMesh( mesh ) ;
+
+  // a new mesh, so the old collapses are no use
+  progressive = ProgressiveMesh() ;
+  if( decimateKeep < 1.f )
+    selectLOD() ;
+  else
+    packMesh() ;
+}
+
+void regen()
+{
+  // streaming generates the field itself
+  if( !( streamSlabs && vizGenMode == VizGenCubes ) )
+    voxelGrid.genData( wTerrain, wTerrainPeriod ) ;
+  genVizFromVoxelData() ;
+}
+
+// Voronoi texture
+struct Site
+{
+  int row,col;
+  Vector2f pos ;
+  Site() : row(0),col(0),pos( 0, 0 ) {}
+  Site( int icol, int irow ) : col(icol),row(irow),pos( icol, irow ) {}
+  
+  inline int getIndex( int rows, int cols ) const { return row*cols + col ; }
+  
+  // I center 
+  Vector2f getWrappedPos( const Vector2f& worldSize, const Vector2f& v ) const
+  {
+    Vector2f offsetToCenter = worldSize/2.f - v ; // takes relativeToV to worldCenter, I may go OOB
+    Vector2f imagePos = pos + offsetToCenter ; // I may go OOB as I am offset by the same amt that makes `this` @ worldCenter
+    return imagePos.wrap( worldSize ) - offsetToCenter ; // wrap to fit in a world of worldSize (+ space world)
+  }
+  
+  float getEuclideanDistance( const Vector2f& worldSize, const Vector2f& v ) const
+  {
+    return distance1( getWrappedPos( worldSize, v ), v ) ;
+  }
+  float getEuclideanDistance2( const Vector2f& worldSize, const Vector2f& v ) const
+  {
+    return distance2( getWrappedPos( worldSize, v ), v ) ;
+  }
+  
+  float getManhattanDistance( const Vector2f& worldSize, const Vector2f& v ) const
+  {
+    return (getWrappedPos( worldSize, v ) - v).fabs().sum() ; //manhattan distance
+  }
+  
+  float getChebyshevChessDistance( const Vector2f& worldSize, const Vector2f& v ) const
+  {
+    return (getWrappedPos( worldSize, v ) - v).max() ;
+  }
+} ;
+
+/// Procedural textures
+struct Texture
+{
+  GLuint texId ;
+  int w,h ;
+  vector<float> vals ; // floating point noise values.
+  
+  // You could work with each color channel separately.
+  // You could map rgb COMPLETELY DIFFERENTLY __at each stage__,
+  // which means rgb would go in totally distinct directions.
+  //vector<Vector4f> colorVals ; // colorized noise values.
+  
+  function<Vector4f ( float val )> colorizationFunc ;
+  
+  Texture( int iw, int ih ) : w(iw), h(ih)
+  {
+    vals.resize( w*h, 0.f ) ;
+    //colorVals.resize( w*h, Vector4f(0,0,0,1) ) ;
+    
+    // The default colorization func is basically grayscale, full alpha
+    colorizationFunc = []( float val ) -> Vector4f {
+      return Vector4f( val,val,val,1.f ) ;
+    } ;
+    
+    clear() ;
+  }
+  
+  ~Texture() {}
+  
+  inline void bind() const {
+    glBindTexture( GL_TEXTURE_2D, texId ) ;  CHECK_GL ;
+  }
+  
+  // clear black, full alpha
+  Texture& clear() {
+    clear( 0 ) ;
+    return *this ;
+  }
+  
+  Texture& clear( float toVal )
+  {
+    for( int i = 0 ; i < w*h ; i++ )
+      vals[ i ] = toVal ;
+    return *this ;
+  }
+  
+  Texture& randomNoise()
+  {
+    for( int i = 0 ; i < h ; i++ ) {
+      for( int j = 0 ; j < w ; j++ ) {
+        int dex = i*w + j ;
+        vals[ dex ] = randFloat() ;
+      }
+    }
+    return *this ;
+  }
+  
+  Texture& checkerboard( int dimX, int dimY, float darkVal, float lightVal )
+  {
+    for( int i = 0 ; i < h ; i++ ) {
+      for( int j = 0 ; j < w ; j++ ) {
+        int dex = i*w + j ;
+        int iCell = i / dimY ;
+        int jCell = j / dimX ;
+        
+        if( iCell % 2 == jCell % 2 )
+          vals[ dex ] = darkVal ;
+        else
+          vals[ dex ] = lightVal ;
+      }
+    }
+    return *this ;
+  }
+  
+  Texture& perlin( int octaves, float octaveScaleFactor, int freqMult )
+  {
+    for( int i = 0 ; i < h ; i++ ) {
+    for( int j = 0 ; j < w ; j++ ) {
+      int dex = i*w + j ;
+      
+      // if the baseFreq is TOO LOW, start at a higher one
+      float x = (float)i/h ;
+      float y = (float)j/w ;
+      
+      float scale = 1.f ;
+      int period = 1 ;
+      
+      // add a few octaves of typical fractal noise
+      for( int i=0 ; i < octaves ; i++ )
+      {
+        vals[dex] += Perlin::pnoise( x, y, period, period ) * scale ;
+
+        // "speed up" x and y
+        x *= freqMult ;
+        y *= freqMult ;
+        scale *= octaveScaleFactor ;
+        
+        // The period of the noise has grown
+        period *= freqMult ;
+
+      }
+    }}
+    return *this ;
+  }
+  
+  // worley's voronoi noise
+  Texture& worley( const vector<Site> &sites )
+  {
+    Vector2f worldSize( h, w ) ;
+    
+    vector<float> distanceBuffer( w*h, 0.f ) ;
+      
+    float largestMinDist = 0.f ;
+    for( int i = 0 ; i < h ; i++ ) {
+      for( int j = 0 ; j < w ; j++ ) {
+        int dex = i*w + j ;
+        
+        // get the min dist to all 12 sites
+        float minDist = HUGE ;
+        Vector2f mePos(j,i);
+        for( int si = 0 ; si < sites.size() ; si++ )
+        {
+          float dist = sites[si].getEuclideanDistance2( worldSize, mePos ) ; //euclidean distance
+          //float dist = sites[si].getManhattanDistance( worldSize, mePos ) ;
+          //float dist = sites[si].getChebyshevChessDistance( worldSize, mePos ) ; //chebyshev (chessboard)
+          
+          if( dist < minDist )  minDist = dist ;
+        }
+        distanceBuffer[ dex ] = minDist ;
+        
+        // After deciding on the minDist for that pixel (to all sites),
+        // see if that was the greatest minDist so far (normalizer)
+        if( minDist > largestMinDist )  largestMinDist = minDist ;
+      }
+    }
+    
+    // COLOR & NORMALIZE
+    for( int i = 0 ; i < h ; i++ ) {
+      for( int j = 0 ; j < w ; j++ ) {
+        int dex = i*w + j ;
+        float s = distanceBuffer[dex] / largestMinDist ;
+        vals[dex] = s ;
+      }
+    }
+    
+    return *this ;
+  }
+  
+  // I DEFINE an 'octave' for worley is "farther distances" (still have yet to verify my terminology with the literature),
+  // the "first octave" are the distances to the CLOSEST sites
+  // "2nd octave" distances to 2nd closest. (I think they call these F1, F2 etc.)
+  // initialScale is the multiplier for the 1st octave.
+  // if octaveScaleFactor is > 1, then the high octaves weigh MORE AND MORE
+  Texture& worley( int numSites, float initialScale, float octaveScaleFactor, int octaves )
+  {
+    vector<Site> sites ; // indices of sites.
+    for( int i = 0 ; i < numSites ; i++ )
+      sites.push_back( Site( randInt( 0, h ), randInt( 0, w ) ) ) ;
+      
+    Vector2f worldSize( h, w ) ;
+    
+    // these store distances in order.
+    vector< vector<float> > distanceBuffer( w*h ) ;
+    
+    for( int i = 0 ; i < h ; i++ ) {
+      for( int j = 0 ; j < w ; j++ ) {
+        int dex = i*w + j ;
+        Vector2f mePos(j,i);
+        
+        // Get all the distances to all the sites.
+        for( int si = 0 ; si < sites.size() ; si++ )
+        {
+          float dist = sites[si].getEuclideanDistance( worldSize, mePos ) ; //euclidean distance
+          //float dist = sites[si].getManhattanDistance( worldSize, mePos ) ;
+          //float dist = sites[si].getChebyshevChessDistance( worldSize, mePos ) ; //chebyshev (chessboard)
+          // chebyshev makes a thatch pattern
+          
+          // find the spot
+          vector<float>::iterator iter = distanceBuffer[dex].begin() ;
+
+          //                                                                                          0.6599          
+          //                                                                                             ^
+          // advance iter until the one it points to exceeds `dist`: they go in ascending order ( 0.4532, 1.1235, 2.23525 )
+          while( iter != distanceBuffer[dex].end() && dist > *iter )  ++iter ;
+          
+          // goes BEFORE iter. (and when iter points to "1 past the end", it goes before that.)
+          distanceBuffer[dex].insert( iter, dist ) ;
+        }
+      }
+    }
+    
+    // NORMALIZE
+    // find the max for each octave
+    vector<float> maxes( octaves, 0.f ) ;
+    for( int i = 0 ; i < w*h ; i++ )
+    {
+      for( int oc = 0 ; oc < octaves ; oc++ )
+      {
+        // "octave 0" is just the closest distance.  here
+        // maxes[0] looks in ALL distanceBuffer[dex] for
+        // the LARGEST "CLOSEST" distance
+        if( maxes[oc] < distanceBuffer[i][oc] )
+          maxes[oc] = distanceBuffer[i][oc] ;
+      }
+    }
+    
+    for( int i = 0 ; i < w*h ; i++ )
+      for( int oc = 0 ; oc < octaves ; oc++ )
+        distanceBuffer[i][oc] /= maxes[oc] ; // normalize EACH OCTAVE
+    
+    float scale = initialScale ;
+    
+    /*
+    // Sum the octaves.
+    for( int oc = 0 ; oc < octaves ; oc++ )
+    {
+      for( int i = 0 ; i < h ; i++ ) {
+      for( int j = 0 ; j < w ; j++ ) {
+        int dex = i*w + j ;
+        
+        // Apply the normalization to each octave here
+        float s = scale * distanceBuffer[dex][oc] / maxes[oc] ;
+        vals[dex] = s ;
+      }}
+      
+      scale *= octaveScaleFactor ;
+    }
+    */
+    
+    // Sum the octaves.
+    for( int i = 0 ; i < h ; i++ ) {
+    for( int j = 0 ; j < w ; j++ ) {
+      int dex = i*w + j ;
+      
+      // Apply the normalization to each octave here
+      float s = distanceBuffer[dex][1] - distanceBuffer[dex][0] ;
+      vals[dex] = s ;
+    }}
+    
+    scale *= octaveScaleFactor ;
+    return *this ;
+  }
+  
+  Texture& operator*=( const Texture& o ) {
+    for( int i = 0 ; i < w*h ; i++ )
+      vals[i] *= o.vals[i] ;
+    return *this ;
+  }
+  
+  Texture& operator/=( const Texture& o ) {
+    for( int i = 0 ; i < w*h ; i++ )
+      vals[i] /= o.vals[i] ;
+    return *this ;
+  }
+  
+  Texture& operator+=( const Texture& o ) {
+    for( int i = 0 ; i < w*h ; i++ )
+      vals[i] += o.vals[i] ;
+    return *this ;
+  }
+  
+  // bias the whole texture by some float val.
+  // useful if you want the MINIMUM value to be some range
+  Texture& operator+=( float val ) {
+    for( int i = 0 ; i < w*h ; i++ )
+      vals[i] += val ;
+    return *this ;
+  }
+  
+  Texture& operator-=( const Texture& o ) {
+    for( int i = 0 ; i < w*h ; i++ )
+      vals[i] -= o.vals[i] ;
+    return *this ;
+  }
+  
+  // FORCES opaque (alpha=1)
+//  Texture& opaque( const Texture& o ) {
+//    for( int i = 0 ; i < w*h ; i++ )
+//      vals[i].a = 1.f ;
+//    return *this ;
+//  }
+  
+  // Finds max component and makes range 0->1 all values
+  Texture& renormalize()
+  {
+    float maxVal=0.f;
+    float minVal=HUGE ;
+    
+    for( int i = 0 ; i < w*h ; i++ ) {
+      if( vals[i] > maxVal )  maxVal = vals[i] ;
+      if( vals[i] < minVal )  minVal = vals[i] ;
+    }
+    
+    // BIAS if -ve
+    // -0.2, 0.0, 0.2 => 0, 0.2, 0.4
+    if( minVal < 0.f ){
+      for( int i = 0 ; i < w*h ; i++ )
+        vals[i] -= minVal ;
+        
+      maxVal -= minVal ;
+    }
+
+    if( maxVal > 0.f )
+      for( int i = 0 ; i < w*h ; i++ )
+        vals[i] /= maxVal ;
+        
+    return *this ;
+  }
+  
+  void createGL()
+  {
+    renormalize() ;
+    
+    vector<unsigned int> texels ;
+    texels.resize( w * h, 0 ) ;
+    
+    // The default is to get the rGBA int from each vector4f
+    for( int i = 0 ; i < w*h ; i++ )
+      texels[i] = colorizationFunc( vals[ i ] ).RGBAInt() ;
+    
+    glGenTextures( 1, &texId ) ;  CHECK_GL ;
+    glBindTexture( GL_TEXTURE_2D, texId ) ;  CHECK_GL ;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);  CHECK_GL ;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);  CHECK_GL ;
+    
+    // we do not want to wrap, this will cause incorrect shadows to be rendered
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT ) ;  CHECK_GL ; //GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT ) ;  CHECK_GL ;
+    
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, &texels[0] ) ;  CHECK_GL ;
+    glActiveTexture( GL_TEXTURE0 ) ;  CHECK_GL ;
+  }
+} ;
+
+
+
+
+
+
+
+
+
+
+
+// Generates the procedural `detail texture`
+void genTex( int w, int h )
+{
+  Texture t1( w, h ) ;
+  Texture t2( w, h ) ;
+  
+  // perlin( int octaves, float initialScale, float octaveScaleFactor, int freqMult )
+  t1.worley( 25, 0.34, 1.3, 2 ) ;
+  t1 += 0.5 ;
+  t1.renormalize() ;
+  
+  t2.perlin( 8, 0.5, 2.0 ) ;
+  t2.renormalize() ;
+  t1 *= t2 ;
+  
+  t1.createGL() ;
+}
+
+
+
+
+
+
+
+
+
+
+
+void init() // Called before main loop to set up the program
+{
+  //initDirections() ;
+  regen() ;
+  genTex( 1024, 1024 ) ;
+  
+  axis.pos = Vector3f( 0, 0, 350 ) ;
+  glClearColor( 0.1, 0.1, 0.1, 0.1 ) ;
+  glEnable( GL_COLOR_MATERIAL ) ;
+
+  //glPointSize(16.f);
+  //for( int i = 0 ; i < 3*1000 ; i++ )
+  //  mesh.verts.push_back( VertexPC( Vector3f::random(-1,1), Vector4f::random() ) ) ;
+  
+  glEnable( GL_BLEND ) ;
+  glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA ) ;
+}
+
+void exportOBJ( const char* filename )
+{
+  FILE* f = fopen( filename, "w" ) ;
+
+  fprintf( f, "# ICE-OSURFACE .obj file output\n" ) ;
+  fprintf( f, "# v//n\n" ) ;
+
+  // what's shown: a level of the progressive mesh goes out with all its verts, its faces just don't use some
+  const vector<VertexPNCT>& verts = shownVerts() ;
+  const vector<int>& indices = shownIndices() ;
+  int numIndices = shownNumIndices() ;
+
+  // Usually it goes v, v, v, v, n, n, n, n
+  for( int i = 0 ; i < verts.size() ; i++ )
+  {
+    fprintf( f, "v %f %f %f\n", verts[i].pos.x, verts[i].pos.y, verts[i].pos.z ) ;
+    //fprintf( f, "vn %f %f %f\n", verts[i].normal.x, verts[i].normal.y, verts[i].normal.z ) ;
+
+    // PER-VERTEX color.  Not recognized by any other program, I made this up.
+    // obj uses MATERIALS which I avoid here.
+    ///fprintf( f, "c %f %f %f %f\n", verts[i].color.x, verts[i].color.y, verts[i].color.z, verts[i].color.w ) ;
+  }
+  
+  for( int i = 0 ; i < verts.size() ; i++ )
+    fprintf( f, "vn %f %f %f\n", verts[i].normal.x, verts[i].normal.y, verts[i].normal.z ) ;
+
+  for( int i = 0 ; i < numIndices ; i+=3 )
+  {
+    // color is not specified here
+    // INDEXING IS 1-BASED, NOT 0-BASED
+    fprintf( f, "f %d//%d %d//%d %d//%d\n",
+      indices[i  ]+1, indices[i  ]+1, 
+      indices[i+1]+1, indices[i+1]+1,
+      indices[i+2]+1, indices[i+2]+1 ) ;
+  }
+
+  fclose( f ) ;
+
+  #ifdef _WIN32
+  system( "start ." ) ; // open the folder in windows explorer
+  #endif
+}
+
+// Fills the inside of the isosurface with tetrahedra (solid marching tets)
+// and writes the volume mesh out for FEM / simulation tools.
+void exportVolume( const char* vtkFilename, const char* meditFilename )
+{
+  if( voxelGrid.voxels.empty() )
+  {
+    printf( "No voxels to export a volume from (slab streaming is on)\n" ) ;
+    return ;
+  }
+
+  VolumeMesh vm ;
+  MarchingTetsT<true,VolumeMeshSink> mt( &voxelGrid, VolumeMeshSink( &vm ), isosurface, White ) ;
+  mt.genVizMarchingTets() ;
+  vm.buildNeighbours() ;
+  printf( "Volume mesh: %d nodes, %d tets\n", (int)vm.nodes.size(), vm.numTets() ) ;
+  vm.exportVTK( vtkFilename ) ;
+  vm.exportMedit( meditFilename ) ;
+}
+
+#ifdef __APPLE__
+KeyMap keyStates ;
+
+bool IS_KEYDOWN( uint16_t vKey )
+{
+  // http://stackoverflow.com/questions/11466294/getting-keyboard-state-using-getkeys-function
+  uint8_t index = vKey / 32 ;
+  uint8_t shift = vKey % 32 ;
+  return keyStates[index].bigEndianValue & (1 << shift) ;
+}
+#endif
+
+void keys()
+{
+  #ifdef _WIN32
+  
+  // Windows makes this easy and nice..
+  #define IS_KEYDOWN( c ) (GetAsyncKeyState( c ) & 0x8000)
+  if( IS_KEYDOWN( 'W' ) )
+    axis.pos += axis.forward * speed ;
+  if( IS_KEYDOWN( 'S' ) )
+    axis.pos -= axis.forward * speed ;
+  if( IS_KEYDOWN( 'A' ) )
+    axis.pos -= axis.right * speed ;
+  if( IS_KEYDOWN( 'D' ) )
+    axis.pos += axis.right * speed ;
+  if( IS_KEYDOWN( 'Q' ) )
+    axis.roll( -speed/15 ) ;
+  if( IS_KEYDOWN( 'E' ) )
+    axis.roll( speed/15 ) ;
+
+  #elif defined __APPLE__
+  
+  GetKeys(keyStates) ;
+  if( IS_KEYDOWN( kVK_ANSI_W ) )
+    axis.pos += axis.forward * speed ;
+  if( IS_KEYDOWN( kVK_ANSI_S ) )
+    axis.pos -= axis.forward * speed ;
+  if( IS_KEYDOWN( kVK_ANSI_A ) )
+    axis.pos -= axis.right * speed ;
+  if( IS_KEYDOWN( kVK_ANSI_D ) )
+    axis.pos += axis.right * speed ;
+  if( IS_KEYDOWN( kVK_ANSI_Q ) )
+    axis.roll( -speed/15 ) ;
+  if( IS_KEYDOWN( kVK_ANSI_E ) )
+    axis.roll( speed/15 ) ;
+
+  
+  #endif
+  }
+
+
+void drawElements( int renderMode, const vector<int>& indices, int numIndices )
+{
+  if( repeats )
+  {
+    for( int i = -1 ; i <= 1 ; i++ )
+    {
+      for( int j = -1 ; j <= 1 ; j++ )
+      {
+        int k = 0 ; //for( int k = -1 ; k <= 1 ; k++ )
+        {
+          glPushMatrix();
+          glTranslatef( i*voxelGrid.worldSize, j*voxelGrid.worldSize, k*voxelGrid.worldSize ) ;
+          glDrawElements( renderMode, numIndices, GL_UNSIGNED_INT, &indices[0] ) ;
+          glPopMatrix();
+        }
+      }
+    }
+  }
+  else
+  {
+    // draw it once
+    glDrawElements( renderMode, numIndices, GL_UNSIGNED_INT, &indices[0] ) ;
+  }
+}
+
+void drawBoundArray( int renderMode, int size )
+{
+  if( repeats )
+  {
+    for( int i = -1 ; i <= 1 ; i++ )
+    {
+      for( int j = -1 ; j <= 1 ; j++ )
+      {
+        int k = 0 ; //for( int k = -1 ; k <= 1 ; k++ )
+        {
+          glPushMatrix();
+          glTranslatef( i*voxelGrid.worldSize, j*voxelGrid.worldSize, k*voxelGrid.worldSize ) ;
+          glDrawArrays( renderMode, 0, size ) ;
+          glPopMatrix();
+        }
+      }
+    }
+  }
+  else
+  {
+    // draw it once
+    glDrawArrays( renderMode, 0, size ) ;
+  }
+}
+
+void drawPacked()
+{
+  if( repeats )
+  {
+    for( int i = -1 ; i <= 1 ; i++ )
+    {
+      for( int j = -1 ; j <= 1 ; j++ )
+      {
+        int k = 0 ; //for( int k = -1 ; k <= 1 ; k++ )
+        {
+          packedMesh.draw( [&]() {
+            glTranslatef( i*voxelGrid.worldSize, j*voxelGrid.worldSize, k*voxelGrid.worldSize ) ;
+          } ) ;
+        }
+      }
+    }
+  }
+  else
+  {
+    // draw it once
+    packedMesh.draw( []() {} ) ;
+  }
+}
+
+// Draws each point in mesh.verts as a cube of side PointCloud::cubeSide().
+// The mesh stays 1 vertex per point, and nothing is expanded per point: the 36 verts of
+// PointCloud::unitCube are the only cube there is, drawn once per point with a glTranslatef
+// to it, in the point's color and texcoord.  The side is 1 glScalef over all of them,
+// so changing cubeSize touches nothing per point.
+void drawPointCubes()
+{
+  const vector<VertexPNCT>& cube = PointCloud::unitCube() ;
+  float side = PointCloud::cubeSide() ;
+  if( side <= 0.f )  return ;
+
+  glVertexPointer( 3, GL_FLOAT, sizeof( VertexPNCT ), &cube[0].pos ) ;
+  glNormalPointer( GL_FLOAT, sizeof( VertexPNCT ), &cube[0].normal ) ;
+  // color and texcoord are per point, not per cube vertex
+  glDisableClientState( GL_COLOR_ARRAY ) ;
+  glDisableClientState( GL_TEXTURE_COORD_ARRAY ) ;
+  glEnable( GL_NORMALIZE ) ; // (the scale scales the normals too)
+
+  auto drawCubes = [&]() {
+    glPushMatrix() ;
+    glScalef( side, side, side ) ;
+    float invSide = 1.f/side ; // the translates are inside the scale
+    for( int i = 0 ; i < mesh.verts.size() ; i++ )
+    {
+      const VertexPNCT& v = mesh.verts[i] ;
+      glColor4fv( &v.color.x ) ;
+      glTexCoord2fv( &v.tex.x ) ;
+      glPushMatrix() ;
+      glTranslatef( v.pos.x*invSide, v.pos.y*invSide, v.pos.z*invSide ) ;
+      glDrawArrays( GL_TRIANGLES, 0, (int)cube.size() ) ;
+      glPopMatrix() ;
+    }
+    glPopMatrix() ;
+  } ;
+
+  if( repeats )
+  {
+    for( int i = -1 ; i <= 1 ; i++ )
+    {
+      for( int j = -1 ; j <= 1 ; j++ )
+      {
+        int k = 0 ; //for( int k = -1 ; k <= 1 ; k++ )
+        {
+          glPushMatrix();
+          glTranslatef( i*voxelGrid.worldSize, j*voxelGrid.worldSize, k*voxelGrid.worldSize ) ;
+          drawCubes() ;
+          glPopMatrix();
+        }
+      }
+    }
+  }
+  else
+  {
+    // draw it once
+    drawCubes() ;
+  }
+
+  glDisable( GL_NORMALIZE ) ;
+  glEnableClientState( GL_COLOR_ARRAY ) ;
+  glEnableClientState( GL_TEXTURE_COORD_ARRAY ) ;
+}
+
+void glutPuts( const char* str, Vector2f pos, const Vector4f& color )
+{
+  // convert x,y to canonical
+  pos.y = h-pos.y ; // invert y
+  float canX = 2*pos.x/w-1, canY=2*pos.y/h-1;
+
+  glRasterPos2f( canX, canY ) ;
+  glColor4fv( &color.x ) ;
+  do glutBitmapCharacter( GLUT_BITMAP_HELVETICA_18, *str ); while( *(++str) ) ;
+}
+
+int glGetPolygonMode()
+{
+  int pMode[2];
+  glGetIntegerv( GL_POLYGON_MODE, pMode ) ;
+  return pMode[0]; /// the 2nd number is front&back or w/e
+}
+
+void draw()
+{
+  keys() ;
+
+  //pw += 0.01f ;
+  //genVoxels() ;
+  glEnable( GL_DEPTH_TEST ) ;
+  glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT ) ;
+
+  //glEnable( GL_CULL_FACE ) ;
+  //glCullFace( GL_BACK ) ;
+
+  glViewport( 0, 0, w, h ) ;
+  glMatrixMode( GL_PROJECTION ) ;
+  glLoadIdentity();
+  //glOrtho( -5, 5, -5, 5, 5, -5 ) ;
+  gluPerspective( 45.0, 1.0, 0.5, 1000.0 ) ;
+  
+  glMatrixMode(GL_MODELVIEW);
+  
+  glLoadIdentity();
+  Matrix4f mat = axis.getViewingMatrix4f() ;
+  glMultMatrixf( &mat.m00 ) ;
+
+  //gluLookAt( 0, 0, sbd,   0, 0, 0,   0, 1, 0 ) ;
+  //glRotatef( my, 1, 0, 0 ) ;
+  //glRotatef( mx, 0, 1, 0 ) ;
+  
+  if( axisLinesOn )
+  {
+    drawAxisLines() ;
+  }
+  
+  // Lights.
+  if( lightingOn )
+  {
+    vector<Vector4f> lightPoses ;
+    float ld = voxelGrid.worldSize ;
+    lightPoses.push_back( Vector4f(  ld,  ld/2, ld, 1 ) ) ;
+    lightPoses.push_back( Vector4f(  ld,  ld,   ld, 1 ) ) ;
+    lightPoses.push_back( Vector4f(   0,  ld,    0, 1 ) ) ;
+    lightPoses.push_back( Vector4f( -ld,   0,    0, 1 ) ) ;
+
+    static float r = 0.f;
+    r += 0.0001f;
+  
+    glDisable( GL_LIGHTING ) ;
+  
+    float white[4] = {1,1,1,1};
+    for( int i = 0 ; i < lightPoses.size() ; i++ )
+    {
+      glEnable( GL_LIGHT0 + i ) ;
+      lightPoses[i].xyz() = Matrix3f::rotationY( r ) * lightPoses[i].xyz() ;
+      glLightfv( GL_LIGHT0 + i, GL_POSITION, &lightPoses[i].x ) ;
+      glLightfv( GL_LIGHT0 + i, GL_DIFFUSE, white ) ;
+      glLightfv( GL_LIGHT0 + i, GL_SPECULAR, white ) ;
+
+      // visualize the light
+      glPushMatrix();
+      glTranslatef( lightPoses[i].x, lightPoses[i].y, lightPoses[i].z ) ;
+      glutSolidSphere( voxelGrid.worldSize/10, 16, 16 ) ;
+      glPopMatrix() ;
+    }
+  
+    Vector4f spec( 1,1,1,50 ) ;
+    glMaterialfv( GL_FRONT_AND_BACK, GL_SPECULAR, &spec.x ) ;
+    glMaterialf( GL_FRONT_AND_BACK, GL_SHININESS, spec.w ) ;
+  
+    glEnable( GL_LIGHTING ) ;
+  }
+  
+  glEnableClientState( GL_VERTEX_ARRAY ) ;  CHECK_GL ;
+  glEnableClientState( GL_NORMAL_ARRAY ) ;  CHECK_GL ;
+  glEnableClientState( GL_COLOR_ARRAY ) ;  CHECK_GL ;
+  glEnableClientState( GL_TEXTURE_COORD_ARRAY ) ;  CHECK_GL ;
+  
+  // Bind a texture to use
+  glEnable( GL_TEXTURE_2D ) ;
+  
+  // DRAW THE MESH
+  needAttribs( AttribAll ) ;
+  if( mesh.verts.size() )
+  {
+    //glDepthMask( 0 ) ;
+    if( mesh.renderMode == GL_POINTS && PointCloud::useCubes )
+      drawPointCubes() ;
+    else if( packedMesh.verts.size() )
+      drawPacked() ;
+    else if( !mesh.indices.size() ) // NO INDEX BUFFER
+    {
+      // vertex arrays with no index buffer
+      glVertexPointer( 3, GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].pos ) ;
+      glNormalPointer( GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].normal ) ;
+      glColorPointer( 4, GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].color ) ;
+      glTexCoordPointer( 2, GL_FLOAT, sizeof( VertexPNCT ), &mesh.verts[0].tex ) ;
+      
+      if( repeats )
+      {
+        for( int i = -1 ; i <= 1 ; i++ )
+        {
+          for( int j = -1 ; j <= 1 ; j++ )
+          {
+            int k = 0 ; //for( int k = -1 ; k <= 1 ; k++ )
+            { 
+              glPushMatrix();
+              glTranslatef( i*voxelGrid.worldSize, j*voxelGrid.worldSize, k*voxelGrid.worldSize ) ;
+              glDrawArrays( mesh.renderMode, 0, (int)mesh.verts.size() ) ;
+              glPopMatrix();
+            }
+          }
+        }
+      }
+      else
+        glDrawArrays( mesh.renderMode, 0, (int)mesh.verts.size() ) ;
+    }
+    else
+    {
+      // Use the index buffer if it exists (the progressive mesh's, when a level of it is shown)
+      const vector<VertexPNCT>& verts = shownVerts() ;
+      glVertexPointer( 3, GL_FLOAT, sizeof( VertexPNCT ), &verts[0].pos ) ;
+      glNormalPointer( GL_FLOAT, sizeof( VertexPNCT ), &verts[0].normal ) ;
+      glColorPointer( 4, GL_FLOAT, sizeof( VertexPNCT ), &verts[0].color ) ;
+      glTexCoordPointer( 2, GL_FLOAT, sizeof( VertexPNCT ), &verts[0].tex ) ;
+      
+      drawElements( mesh.renderMode, shownIndices(), shownNumIndices() ) ;
+    }
+    //glDepthMask( 1 ) ;
+  }
+  
+  glDisableClientState( GL_NORMAL_ARRAY ) ;  CHECK_GL ;
+  glDisableClientState( GL_TEXTURE_COORD_ARRAY ) ;  CHECK_GL ;
+  glDisable( GL_TEXTURE_2D ) ;
+  glDisable( GL_LIGHTING ) ;
+  
+  // Draw some debug lines etc.
+  if( showGradients )
+  {
+    glVertexPointer( 3, GL_FLOAT, sizeof( VertexPC ), &gradients[0].pos ) ;
+    glColorPointer( 4, GL_FLOAT, sizeof( VertexPC ), &gradients[0].color ) ;
+
+    drawBoundArray( GL_LINES, (int)gradients.size() ) ;
+  }
+  if( debugLines.size() )
+  {
+    glVertexPointer( 3, GL_FLOAT, sizeof( VertexPC ), &debugLines[0].pos ) ;
+    glColorPointer( 4, GL_FLOAT, sizeof( VertexPC ), &debugLines[0].color ) ;
+    
+    drawBoundArray( GL_LINES, (int)debugLines.size() ) ;
+  }
+  glDisableClientState( GL_VERTEX_ARRAY ) ;
+  glDisableClientState( GL_COLOR_ARRAY ) ;
+  
+
+  
+  //TEXT
+  glMatrixMode( GL_MODELVIEW ) ;
+  glLoadIdentity() ;
+  glMatrixMode( GL_PROJECTION ) ;
+  glLoadIdentity();
+  glDisable( GL_DEPTH_TEST ) ;
+  
+  // subwindow overlay
+  glEnable( GL_TEXTURE_2D ) ;
+  glEnableClientState( GL_VERTEX_ARRAY ) ;  CHECK_GL ;
+  glEnableClientState( GL_COLOR_ARRAY ) ;  CHECK_GL ;
+  glEnableClientState( GL_TEXTURE_COORD_ARRAY ) ;  CHECK_GL ;
+  
+  int swSize=180, swMargin=10;
+  glViewport( w - swSize-swMargin, swMargin, swSize, swSize ) ;
+  float m=2.f;
+  static VertexPCT subWindowQuad[6] = {
+    VertexPCT( Vector3f(-1,-1,0), 1, Vector2f(0,0) ),
+    VertexPCT( Vector3f(1,-1,0), 1, Vector2f(m,0) ),
+    VertexPCT( Vector3f(1,1,0), 1, Vector2f(m,m) ),
+    
+    VertexPCT( Vector3f(-1,-1,0), 1, Vector2f(0,0) ),
+    VertexPCT( Vector3f(1, 1, 0), 1, Vector2f(m,m) ),
+    VertexPCT( Vector3f(-1, 1, 0), 1, Vector2f(0,m) )
+  } ;
+  
+  glVertexPointer( 3, GL_FLOAT, sizeof( VertexPCT ), &subWindowQuad[0].pos ) ;
+  glColorPointer( 4, GL_FLOAT, sizeof( VertexPCT ), &subWindowQuad[0].color ) ;
+  glTexCoordPointer( 2, GL_FLOAT, sizeof( VertexPCT ), &subWindowQuad[0].tex ) ;
+  
+  glDrawArrays( GL_TRIANGLES, 0, 6 ) ;
+  
+  glDisableClientState( GL_VERTEX_ARRAY ) ;  CHECK_GL ;
+  glDisableClientState( GL_COLOR_ARRAY ) ;  CHECK_GL ;
+  glDisableClientState( GL_TEXTURE_COORD_ARRAY ) ;  CHECK_GL ;
+  glDisable( GL_TEXTURE_2D ) ;
+  
+  if( displayTextOn )
+  {
+    // back to full for text
+    glViewport( 0, 0, w, h ) ;
+    int polyMode ;
+    glGetIntegerv( GL_POLYGON_MODE, &polyMode ) ;
+    char buf[1024];
+    int pos = sprintf( buf, "(!)export (@)export volume (RMB)pick " ) ;
+    pos += sprintf( buf+pos, " (2)%s", glGetPolygonMode()==GL_FILL?"wireframe":"solid" ) ;
+    
+    // if you are in pts mode, special set of options available to you
+    if( vizGenMode==VizGenPts )
+    {
+      if( reconstructPts )
+        pos += sprintf( buf+pos, ptsWithoutNormals?" (9)show points (0)field normals":" (9)show points (0)estimate normals" ) ;
+      else if( PointCloud::useCubes )
+        pos += sprintf( buf+pos, " (3)render points (p/P)cubesize (9)reconstruct" ) ;
+      else
+        pos += sprintf( buf+pos, " (3)render cubes (p/P)ointsize (9)reconstruct" ) ;
+    }
+    else if( vizGenMode==VizGenCubes )
+      pos += sprintf( buf+pos, streamSlabs?" (8)dense grid":" (8)stream slabs" ) ;
+    else if( vizGenMode==VizGenNets )
+      pos += sprintf( buf+pos, dualContour?" (3)surface nets":" (3)dual contour" ) ;
+    pos += sprintf( buf+pos, packedVerts?" (6)float verts":" (6)packed verts" ) ;
+    pos += sprintf( buf+pos, repeats?" un(r)epeat":" (r)epeat" ) ;
+    
+    float yPos = 0.f, yi = 30.f ;
+    glutPuts( buf, Vector2f( 20, yPos+=yi ), White ) ;
+
+    int numPts = (int)mesh.verts.size() ;
+    const char* ptsOrTris = "pts" ;
+    if( mesh.renderMode==GL_TRIANGLES )
+    {
+      if( mesh.indices.size() )
+        numPts = shownNumIndices()/3 ;
+      else
+        numPts /= 3 ;
+      ptsOrTris = "tris" ;
+    }
+    else
+    {
+      
+    }
+    
+    sprintf( buf, "(t) %s (k)gridSize=%d / %s=%d (+/-)w=%.2f (i/I)isosurface=%.2f",
+      VizGenModeName[ vizGenMode ],
+      voxelGrid.dims.x, ptsOrTris, numPts,
+      wTerrain, isosurface ) ;
+    glutPuts( buf, Vector2f(20, yPos+=yi), White ) ;
+    sprintf( buf, "(n/N)minEdgeLength=%.3f (u/U)taubin passes=%d (v/V)decimate to %.0f%% (g/G)speed=%.2f (j/J)worldSize=%.2f",
+      minEdgeLength, taubinPasses, 100*decimateKeep, speed, voxelGrid.worldSize ) ;
+    
+    glutPuts( buf, Vector2f(20, h-yi), White ) ;
+  }
+  
+  glutSwapBuffers();
+}
+
+// Called every time a window is resized to resize the projection matrix
+void resizeWindow( int newWidth, int newHeight )
+{
+  w = newWidth ;
+  h = newHeight ;
+}
+
+// RMB: casts a ray from the eye through pixel (x,y) into the voxel field,
+// and marks where it first crosses the isosurface with a red cross.
+void pick( int x, int y )
+{
+  // matches the gluPerspective( 45, 1, ... ) in draw()
+  float tanHalfFov = tanf( RADIANS( 45.f/2 ) ) ;
+  float ndcX = 2.f*x/w - 1.f, ndcY = 1.f - 2.f*y/h ;
+  Vector3f dir = ( axis.forward + axis.right*( ndcX*tanHalfFov ) + axis.up*( ndcY*tanHalfFov ) ).normalizedCopy() ;
+
+  float t ;
+  voxelGrid.castRays( &axis.pos, &dir, 1, isosurface, 2*voxelGrid.worldSize, &t ) ;
+  if( t < 0 )
+  {
+    puts( "pick: no isosurface along that ray" ) ;
+    return ;
+  }
+  Vector3f hit = axis.pos + dir*t ;
+  printf( "pick: (%.2f %.2f %.2f), %.2f away\n", hit.x, hit.y, hit.z, t ) ;
+  float s = 0.25f*voxelGrid.gridSizer.x ;
+  for( int axisIndex = 0 ; axisIndex < 3 ; axisIndex++ )
+  {
+    Vector3f arm ;
+    arm.elts[axisIndex] = s ;
+    addDebugLine( hit - arm, Red, hit + arm, Red ) ;
+  }
+}
+
+static int lastX=0, lastY=0 ;
+static int mmode=0;
+void mouseMotion( int x, int y )
+{
+  int dx = x-lastX, dy=y-lastY ;
+  
+  // LMB
+  if( mmode == GLUT_LEFT_BUTTON )
+  {
+    mouseX += dx, mouseY += dy ;
+    axis.yaw( 0.01f*dx ) ;
+    axis.pitch( 0.01f*dy ) ;
+  }
+  else if( mmode == GLUT_RIGHT_BUTTON )
+  {
+  }
+  
+  lastX=x,lastY=y;
+}
+
+void mouse( int button, int state, int x, int y )
+{
+  lastX = x ;
+  lastY = y ;
+  
+  mmode=button; // 0 for LMB, 2 for RMB
+  //printf( "%d %d %d %d\n", button,state,x,y ) ;
+
+  if( button == GLUT_RIGHT_BUTTON && state == GLUT_DOWN )
+    pick( x, y ) ;
+}
+
+void keyboard( unsigned char key, int x, int y )
+{
+  float diff = 0.01f ;
+  
+  switch( key )
+  {
+  case '!':
+    if( vizGenMode == VizGenPts )
+    {
+      // the points aren't triangles, so they go out as a point cloud
+      PointCloud pc( &voxelGrid, &mesh.verts, isosurface, White ) ;
+      pc.exportPLY( "exported.ply" ) ;
+    }
+    else if( packedMesh.verts.size() )
+    {
+      needAttribs( AttribAll ) ; // (repacks, if it fills any in)
+      packedMesh.exportPLY( "exported.ply" ) ;
+    }
+    else
+      exportOBJ( "exported.obj" ) ; // (positions and normals only, so it needs no attributes)
+    break ;
+
+  case '@':
+    exportVolume( "exported.vtk", "exported.mesh" ) ;
+    break ;
+
+  case '2':
+    {
+    int polyMode = glGetPolygonMode() ;
+    if( polyMode == GL_FILL )  glPolygonMode( GL_FRONT_AND_BACK, GL_LINE ) ;
+    else  glPolygonMode( GL_FRONT_AND_BACK, GL_FILL ) ;
+    }
+    break ;
+
+  case '3':
+    if( vizGenMode == VizGenPts )
+    {
+      PointCloud::useCubes = !PointCloud::useCubes ; // just changes how the points are drawn
+    }
+    else if( vizGenMode == VizGenNets )
+    {
+      dualContour = !dualContour ;
+      genVizFromVoxelData() ;
+    }
+    break ;
+    
+  case '4':
+    EPS += 1e-2f ;
+    regen() ;
+    break;
+  case '$':
+    EPS -= 1e-2f ;
+    regen() ;
+    break ;
+    
+  case '5':
+    displayTextOn = !displayTextOn ;
+    break ;
+
+  case '6':
+    packedVerts = !packedVerts ;
+    packMesh() ;
+    break ;
+
+  case '7':
+    axisLinesOn = !axisLinesOn ;
+    break ;
+
+  case '8':
+    if( vizGenMode == VizGenCubes )
+    {
+      streamSlabs = !streamSlabs ;
+      regen() ;
+    }
+    break ;
+
+  case '9':
+    if( vizGenMode == VizGenPts )
+    {
+      reconstructPts = !reconstructPts ;
+      genVizFromVoxelData() ;
+    }
+    break ;
+
+  case '0':
+    if( vizGenMode == VizGenPts && reconstructPts )
+    {
+      ptsWithoutNormals = !ptsWithoutNormals ;
+      genVizFromVoxelData() ;
+    }
+    break ;
+    
+  case '=':
+    wTerrain+=diff;
+    regen();
+    break;
+  
+  case '+':
+    wTerrain+=10*diff;
+    regen() ;
+    break;
+  
+  case '-':
+    wTerrain-=diff;
+    regen();
+    break; 
+  
+  case '_':
+    wTerrain-=10*diff;
+    regen();
+    break;
+
+  case 'i':
+    isosurface += 0.01f ;
+    regen();
+    break ;
+
+  case 'I':
+    isosurface -= 0.01f ;
+    regen();
+    break ;
+
+  case 'c':
+    debugLines.clear() ;
+    break ;
+
+  case 'g':
+    speed += 0.01f;
+    break ;
+  case 'G':
+    speed -= 0.01f;
+    break; 
+  case 'h':
+    showGradients = !showGradients ;
+    break ;
+
+  case 'j':
+    voxelGrid.increaseWorldSize( 10 ) ;
+    regen() ;
+    break;
+
+  case 'J':
+    voxelGrid.increaseWorldSize( -10 ) ;
+    regen() ;
+    break; 
+
+  // refine the grid
+  // (the mesh changes size with it, so its scratch is let go rather than kept at the old size)
+  case 'k':
+    voxelGrid.increaseResolution( 1 ) ;
+    mesh.scratch.release() ;
+    regen() ;
+    break ;
+
+  case 'K':
+    voxelGrid.increaseResolution( -1 ) ;
+    mesh.scratch.release() ;
+    regen() ;
+    break ;
+
+  case 'l':
+    lineWidth++;
+    clamp( lineWidth, 1.f, 16.f ) ;
+    glLineWidth( lineWidth ) ;
+    break; 
+  case 'L':
+    lineWidth--;
+    clamp( lineWidth, 1.f, 16.f ) ;
+    glLineWidth( lineWidth ) ;
+    break;
+    
+  case 'n':
+    minEdgeLength += 0.1 ;
+    regen() ;
+    break ;
+  case 'N':
+    minEdgeLength -= 0.1 ;
+    regen() ;
+    break ;
+  case 'u':
+    taubinPasses++ ;
+    genVizFromVoxelData() ;
+    break ;
+  case 'U':
+    taubinPasses = max( taubinPasses-1, 0 ) ;
+    genVizFromVoxelData() ;
+    break ;
+  case 'v':
+    decimateKeep = max( decimateKeep/2, 1.f/64 ) ;
+    selectLOD() ;
+    break ;
+  case 'V':
+    decimateKeep = min( decimateKeep*2, 1.f ) ;
+    selectLOD() ;
+    break ;
+  case 'm':
+    needAttribs( AttribColor ) ;
+    for( int i = 0 ;  i < mesh.verts.size() ; i++ )
+      addDebugLine( mesh.verts[i].pos, Black, mesh.verts[i].pos+mesh.verts[i].normal*1, mesh.verts[i].color ) ;
+    break; 
+
+  case 'p':
+    if( PointCloud::useCubes )
+    {
+      PointCloud::cubeSize += 1 ; // the cubes are sized at draw time
+    }
+    else
+    {
+      PointCloud::ptSize++;
+      ::clamp( PointCloud::ptSize, 1, 16 ) ;
+      glPointSize( PointCloud::ptSize ) ;
+    } 
+    break ;
+  case 'P':
+    if( PointCloud::useCubes )
+    {
+      PointCloud::cubeSize -= 1 ;
+    }
+    else
+    {
+      PointCloud::ptSize--;
+      ::clamp( PointCloud::ptSize, 1, 16 ) ;
+      glPointSize( PointCloud::ptSize ) ;
+    }
+    break ;
+  case 'r': repeats = !repeats ; break ;
+  case 't':
+    cycleFlag( vizGenMode, VizGenMode::VizGenCubes, VizGenMode::VizGenNets ) ;
+    regen() ;
+    break; 
+  case 'T':
+    decycleFlag( vizGenMode, VizGenMode::VizGenCubes, VizGenMode::VizGenNets ) ;
+    regen() ;
+    break; 
+
+  // (wTexture only changes the colors)
+  case 'y':
+    wTexture += 0.01f ;
+    meshAttribs &= ~AttribColor ;
+    needAttribs( AttribColor ) ;
+    break ;
+
+  case 'Y':
+    wTexture -= 0.01f ;
+    meshAttribs &= ~AttribColor ;
+    needAttribs( AttribColor ) ;
+    break ;
+
+  case 'z':
+    lightingOn=!lightingOn ;
+    break ;
+  case 27:
+    exit(0);
+    break;
+    
+  default:
+    break;
+  }
+}
+
+// -bench [gridSize]: runs the marching cubes pipeline without opening a window,
+// printing how long each stage takes and how well the triangle order uses the vertex cache.
+int bench( int gridSize )
+{
+  voxelGrid.dims = Vector3i( gridSize ) ;
+  Timer timer ;
+  printf( "%-24s %10s\n", "stage", "seconds" ) ;
+
+  voxelGrid.genData( wTerrain, wTerrainPeriod ) ;
+  printf( "%-24s %10.3f\n", "genData", timer.getTime() ) ;
+
+  timer.reset() ;
+  MarchingCubes mc( &voxelGrid, &mesh.verts, isosurface, White ) ;
+  mc.genVizMarchingCubes() ;
+  printf( "%-24s %10.3f  (%d verts)\n", "genVizMarchingCubes", timer.getTime(), (int)mesh.verts.size() ) ;
+
+  timer.reset() ;
+  mesh.smoothMesh( &voxelGrid, minEdgeLength ) ;
+  printf( "%-24s %10.3f  (%d verts, %d tris)\n", "smoothMesh", timer.getTime(), (int)mesh.verts.size(), (int)mesh.indices.size()/3 ) ;
+
+  // (after smoothMesh, from where the verts ended up, like needAttribs does it)
+  timer.reset() ;
+  mesh.vertexTexture( wTexture, wTexturePeriod, voxelGrid.worldSize, textureRepeats, AttribColor ) ;
+  double colorTime = timer.getTime() ;
+  timer.reset() ;
+  mesh.vertexTexture( wTexture, wTexturePeriod, voxelGrid.worldSize, textureRepeats, AttribTexCoord ) ;
+  double texTime = timer.getTime() ;
+  printf( "%-24s %10.3f  (color %.4f, texcoords %.4f)\n", "vertexTexture", colorTime + texTime, colorTime, texTime ) ;
+
+  timer.reset() ;
+  smoother.setup() ;
+  double setupTime = timer.getTime() ;
+  const int passes = 10 ;
+  timer.reset() ;
+  for( int p = 0 ; p < passes ; p++ )
+  {
+    smoother.step( smoother.pos[0], smoother.pos[1], 0.5f ) ;
+    smoother.step( smoother.pos[1], smoother.pos[0], -0.53f ) ;
+  }
+  double stepsTime = timer.getTime() ;
+  printf( "%-24s %10.3f  (setup %.3f, %.1f M verts/s a step)\n", "TaubinSmoother x10", setupTime + stepsTime,
+    setupTime, mesh.verts.size()*2.0*passes/stepsTime/1e6 ) ;
+
+  VertexCacheStats before = vertexCacheStats( mesh.indices, (int)mesh.verts.size() ) ;
+  timer.reset() ;
+  optimizeMesh( mesh ) ;
+  printf( "%-24s %10.3f\n", "optimizeMesh", timer.getTime() ) ;
+  VertexCacheStats after = vertexCacheStats( mesh.indices, (int)mesh.verts.size() ) ;
+
+  printf( "vertex cache (FIFO 16): ACMR %.3f => %.3f, ATVR %.3f => %.3f\n",
+    before.acmr, after.acmr, before.atvr, after.atvr ) ;
+
+  timer.reset() ;
+  packedMesh.pack( mesh, Vector3f( -voxelGrid.worldSize/2 ), Vector3f( voxelGrid.worldSize/2 ) ) ;
+  printf( "%-24s %10.3f\n", "PackedMesh::pack", timer.getTime() ) ;
+  float maxPosErr = 0.f, maxNormalErr = 0.f ;
+  for( int i = 0 ; i < mesh.verts.size() ; i++ )
+  {
+    maxPosErr = max( maxPosErr, ( packedMesh.getPos( i ) - mesh.verts[i].pos ).len() ) ;
+    maxNormalErr = max( maxNormalErr, ( packedMesh.getNormal( i ) - mesh.verts[i].normal ).len() ) ;
+  }
+  printf( "packed verts: %d => %d bytes, max error pos %g (%.4f%% of worldSize) normal %g\n",
+    (int)( mesh.verts.size()*sizeof( VertexPNCT ) ), (int)( packedMesh.verts.size()*sizeof( VertexPacked ) ),
+    maxPosErr, 100*maxPosErr/voxelGrid.worldSize, maxNormalErr ) ;
+
+  timer.reset() ;
+  progressive.build( mesh, &voxelGrid ) ;
+  printf( "%-24s %10.3f  (%d collapses, %d => %d tris)\n", "ProgressiveMesh::build", timer.getTime(),
+    (int)progressive.collapses.size(), progressive.fullTris(), progressive.coarsestTris ) ;
+  // A level change is all v/V do: the level draws straight from the progressive mesh's arrays,
+  // in the order mesh was optimized to before the build, which only holds within each death step
+  // (so the ACMR is the cost of not reordering).  At 100% it's mesh that's drawn.
+  float keeps[] = { 0.5f, 0.25f, 0.125f, 0.25f } ;
+  for( float keep : keeps )
+  {
+    timer.reset() ;
+    int tris = progressive.setTriangleCount( (int)( keep*progressive.fullTris() ) ) ;
+    double lodTime = timer.getTime() ;
+    vector<int> live( progressive.indices.begin(), progressive.indices.begin() + 3*tris ) ;
+    printf( "  level %3.0f%% (%6d tris) %10.6f, ACMR %.3f\n", 100*keep, tris, lodTime,
+      vertexCacheStats( live, (int)progressive.verts.size() ).acmr ) ;
+  }
+
+  // The whole regen a few times over (with Taubin passes and packed verts on too),
+  // and the attributes the window's next draw asks for:
+  // the first ones grow the scratch, after that a regen should hardly allocate at all.
+  taubinPasses = 2 ;
+  packedVerts = 1 ;
+  printf( "allocations a regen:" ) ;
+  for( int r = 0 ; r < 4 ; r++ )
+  {
+    long long before = numAllocations ;
+    timer.reset() ;
+    regen() ;
+    needAttribs( AttribAll ) ;
+    printf( " %lld (%.3fs)", numAllocations - before, timer.getTime() ) ;
+  }
+  printf( "\n" ) ;
+
+  // what the .obj export asks for
+  timer.reset() ;
+  regen() ;
+  printf( "regen, geometry only: %.3fs\n", timer.getTime() ) ;
+  return 0 ;
+}
+
+int main( int argc, char **argv )
+{
+  if( argc > 1 && !strcmp( argv[1], "-bench" ) )
+    return bench( argc > 2 ? atoi( argv[2] ) : 64 ) ;
+
+  glutInit( &argc, argv ) ; // Initializes glut
+
+  glutInitDisplayMode( GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGBA ) ;
+  glutInitWindowSize( w, h ) ;
+  glutInitWindowPosition( 0, 0 ) ;
+  glutCreateWindow( "Isosurface contour from 3D Perlin noise" ) ;
+  glutReshapeFunc( resizeWindow ) ;
+  glutDisplayFunc( draw ) ;
+  glutIdleFunc( draw ) ;
+  
+  glutMotionFunc( mouseMotion ) ;
+  glutMouseFunc( mouse ) ;
+  
+  glutKeyboardFunc( keyboard ) ;
+
+  init();
+
+  glutMainLoop();
+  return 0;
+}
+
+
+
+
+
+
+
+
+
+
+
+